@@ -0,0 +1,64 @@
+// Compares the ways of handing a String to a C API: String::c_str, which reads the terminator kept
+// behind the chars, against String::to_c_string and String::to_std_string, which copy.
+//
+// Usage: CStrBench [calls] [length]
+
+#include "String.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+// stands in for open(), getaddrinfo() or sqlite3_prepare(): reads the string up to its '\0'
+static std::size_t c_api(const char* path) {
+    return std::strlen(path);
+}
+
+template<class Function>
+static double measure(const char* name, std::size_t calls, Function&& function) {
+    const auto start   = std::chrono::steady_clock::now();
+    const auto checked = function();
+    const auto end     = std::chrono::steady_clock::now();
+    const auto seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << name << ": " << seconds * 1e9 / double(calls) << " ns per call (" << checked << ")" << std::endl;
+    return seconds;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t calls  = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const std::size_t length = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 40;
+
+    // a few different paths, so the calls don't all hit the same cache line
+    std::vector<String> paths;
+    for (std::size_t i = 0; i < 64; ++i) {
+        String path("/var/lib/");
+        while (path.size() < length)
+            path += String(char('a' + (i + path.size()) % 26));
+        paths.push_back(path);
+    }
+
+    const auto copy_time = measure("String::to_c_string", calls, [&] {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < calls; ++i)
+            total += c_api(paths[i % paths.size()].to_c_string().get());
+        return total;
+    });
+
+    measure("String::to_std_string", calls, [&] {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < calls; ++i)
+            total += c_api(paths[i % paths.size()].to_std_string().c_str());
+        return total;
+    });
+
+    const auto c_str_time = measure("String::c_str", calls, [&] {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < calls; ++i)
+            total += c_api(paths[i % paths.size()].c_str());
+        return total;
+    });
+
+    std::cout << "speedup over to_c_string: " << copy_time / c_str_time << "x" << std::endl;
+}
@@ -0,0 +1,63 @@
+// Compares CsvReader against parsing with String::split, which is what CsvReader replaces.
+//
+// Usage: CsvBench [rows]
+
+#include "Csv.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+static String make_input(std::size_t rows) {
+    std::stringstream ss;
+    for (std::size_t i = 0; i < rows; ++i) {
+        ss << i << ",some_name_" << i << ",3.1415,\"quoted, with delimiter\",last field of the row\n";
+    }
+    return String(ss.str().c_str());
+}
+
+template<class Function>
+static double measure(const char* name, std::size_t bytes, Function&& function) {
+    const auto start   = std::chrono::steady_clock::now();
+    const auto fields  = function();
+    const auto end     = std::chrono::steady_clock::now();
+    const auto seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << name << ": " << fields << " fields in " << seconds * 1000.0 << " ms, "
+              << (double(bytes) / (1024.0 * 1024.0)) / seconds << " MiB/s" << std::endl;
+    return seconds;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t rows  = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500000;
+    const String      input = make_input(rows);
+
+    // split does not understand quotes, so it yields one more field per row. It's the work that matters.
+    const auto split_time = measure("String::split", input.size(), [&] {
+        std::size_t fields = 0;
+        for (const auto& line : input.split('\n', rows + 1))
+            fields += line.split(',', 8).size();
+        return fields;
+    });
+
+    const auto reader_time = measure("CsvReader (String)", input.size(), [&] {
+        std::size_t fields = 0;
+        CsvReader   reader(input);
+        CsvRecord   record;
+        while (reader.next(record))
+            fields += record.size();
+        return fields;
+    });
+
+    std::istringstream stream(input.to_std_string());
+    measure("CsvReader (istream)", input.size(), [&] {
+        std::size_t fields = 0;
+        CsvReader   reader(stream);
+        CsvRecord   record;
+        while (reader.next(record))
+            fields += record.size();
+        return fields;
+    });
+
+    std::cout << "speedup over split: " << split_time / reader_time << "x" << std::endl;
+}
@@ -0,0 +1,75 @@
+// Compares rendering a notification with a compiled Template against the String::replace chain it
+// replaces: one copy of the template text, then one replace call per placeholder.
+//
+// Usage: TemplateBench [renders]
+
+#include "String.h"
+#include "Template.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+template<class Function>
+static double measure(const char* name, std::size_t renders, Function&& function) {
+    const auto start   = std::chrono::steady_clock::now();
+    const auto checked = function();
+    const auto end     = std::chrono::steady_clock::now();
+    const auto seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << name << ": " << seconds * 1e9 / double(renders) << " ns per render (" << checked << ")" << std::endl;
+    return seconds;
+}
+
+int main(int argc, char** argv) {
+    const std::size_t renders = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    const String source("Hello ${name}, your order ${id} of ${count} items ships to ${city} on ${date}. "
+                        "Track order ${id} at https://example.com/orders/${id}.");
+    // a few different customers, so the values don't all hit the same cache line
+    std::vector<std::unordered_map<std::string_view, String>> customers;
+    const char* names[] = { "Ada", "Grace Hopper", "Linus", "Barbara Liskov" };
+    const char* cities[] = { "London", "Arlington", "Helsinki", "Los Angeles" };
+    for (std::size_t i = 0; i < 4; ++i)
+        customers.push_back({
+            { "name", names[i] },
+            { "id", String::format(100000 + i * 7919) },
+            { "count", String::format(i + 1) },
+            { "city", cities[i] },
+            { "date", String("2024-05-0") + String::format(i + 1) },
+        });
+
+    const auto replace_time = measure("String::replace per placeholder", renders, [&] {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < renders; ++i) {
+            const auto& values = customers[i % customers.size()];
+            String      text   = source;
+            for (const auto& [key, value] : values)
+                text.replace(String("${") + String(key) + "}", value);
+            total += text.size();
+        }
+        return total;
+    });
+
+    const Template compiled(source);
+    measure("Template::render", renders, [&] {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < renders; ++i)
+            total += compiled.render(customers[i % customers.size()]).size();
+        return total;
+    });
+
+    String     out;
+    const auto render_to_time = measure("Template::render_to, reused buffer", renders, [&] {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < renders; ++i) {
+            compiled.render_to(out, customers[i % customers.size()]);
+            total += out.size();
+        }
+        return total;
+    });
+
+    std::cout << "speedup over replace: " << replace_time / render_to_time << "x" << std::endl;
+}
@@ -0,0 +1,137 @@
+#ifndef CSV_H
+#define CSV_H
+
+#include "String.h"
+
+#include <istream>
+#include <string_view>
+#include <vector>
+
+/// \brief Describes the flavour of delimiter-separated text a CsvReader parses.
+///
+/// Example, semicolon-separated with backslash escapes:
+///
+///     CsvDialect dialect = CsvDialect::csv();
+///     dialect.delimiter  = ';';
+///     dialect.escape     = '\\';
+///
+struct CsvDialect {
+    /// \brief Separates fields within a record.
+    char delimiter { ',' };
+    /// \brief Encloses fields which contain delimiters, quotes or newlines. `'\0'` disables quoting.
+    char quote { '"' };
+    /// \brief Makes the following char literal, inside and outside of quotes. `'\0'` disables escaping.
+    char escape { '\0' };
+    /// \brief Whether two quotes inside a quoted field stand for one literal quote (RFC 4180).
+    bool double_quote { true };
+    /// \brief Whether lines without any content are skipped instead of yielding a record with one
+    /// empty field.
+    bool skip_empty_lines { true };
+
+    /// \brief RFC 4180 comma-separated values.
+    static CsvDialect csv();
+    /// \brief Tab-separated values without quoting, as written by most spreadsheet programs.
+    static CsvDialect tsv();
+};
+
+/// \brief One record (line) of delimiter-separated text, as a list of fields.
+///
+/// Fields are views. Fields which did not need unescaping point directly into the input of the
+/// CsvReader, others point into storage owned by the record. Either way, a field stays valid until
+/// the record is passed to CsvReader::next again, or the input goes away.
+class CsvRecord
+{
+private:
+    struct Span {
+        std::size_t offset;
+        std::size_t size;
+        bool        in_scratch;
+        const char* data;
+    };
+
+    std::vector<std::string_view> m_fields;
+    std::vector<Span>             m_spans;
+    std::vector<char>             m_scratch;
+
+    friend class CsvReader;
+
+public:
+    using ConstIterator = std::vector<std::string_view>::const_iterator;
+
+    /// \brief Amount of fields in this record.
+    std::size_t size() const noexcept { return m_fields.size(); }
+    /// \brief True if the record has no fields.
+    bool empty() const noexcept { return m_fields.empty(); }
+    /// \brief The field at index `i`. No bounds checking is done.
+    std::string_view operator[](std::size_t i) const { return m_fields[i]; }
+    /// \brief The field at index `i`.
+    /// \throw std::out_of_range if `i` is an invalid index
+    std::string_view at(std::size_t i) const { return m_fields.at(i); }
+
+    ConstIterator begin() const { return m_fields.begin(); }
+    ConstIterator end() const { return m_fields.end(); }
+
+    /// \brief Copies of all fields, as owning Strings.
+    std::vector<String> to_strings() const;
+};
+
+/// \brief Streaming reader for comma-, tab- or otherwise delimiter-separated text.
+///
+/// Handles quoted fields, escaped and doubled quotes, as well as LF and CRLF line endings. Fields
+/// are yielded as views into the input, so only fields that actually contain escape sequences are
+/// ever copied. Delimiters, quotes and newlines are located 16 bytes at a time.
+///
+/// Example
+///
+///     CsvReader reader(my_string);
+///     CsvRecord record;
+///     while (reader.next(record)) {
+///         std::cout << record[0] << std::endl;
+///     }
+///
+/// \attention The reader does not copy in-memory input. The String or buffer it was created from
+/// must outlive it.
+class CsvReader
+{
+private:
+    CsvDialect        m_dialect;
+    std::istream*     m_stream { nullptr };
+    std::vector<char> m_buffer;
+    const char*       m_begin { nullptr };
+    const char*       m_end { nullptr };
+    bool              m_eof { true };
+    std::size_t       m_chunk_size { 0 };
+    std::size_t       m_records { 0 };
+
+    enum class Status
+    {
+        Complete,
+        NeedMore,
+    };
+
+    Status parse_record(const char*& pos, CsvRecord& record) const;
+    bool   refill();
+
+public:
+    /// \brief Reads from the String `input`, which must outlive the reader.
+    explicit CsvReader(const String& input, CsvDialect dialect = CsvDialect::csv());
+    /// \brief Reads from a raw buffer, for example a memory mapped file, which must outlive the reader.
+    explicit CsvReader(std::string_view input, CsvDialect dialect = CsvDialect::csv());
+    /// \brief Reads from a stream, `chunk_size` bytes at a time. Records may span chunks.
+    /// Fields are views into an internal buffer which is reused by the next call to `next`.
+    explicit CsvReader(std::istream& input, CsvDialect dialect = CsvDialect::csv(), std::size_t chunk_size = 64 * 1024);
+    CsvReader(String&&, CsvDialect = CsvDialect::csv()) = delete;
+
+    /// \brief Parses the next record into `record`, reusing its storage.
+    /// \return false if there are no more records.
+    /// \throw std::runtime_error on malformed input, like an unterminated quoted field.
+    bool next(CsvRecord& record);
+
+    /// \brief Amount of records read so far.
+    std::size_t records() const noexcept { return m_records; }
+
+    /// \brief The dialect used by this reader.
+    const CsvDialect& dialect() const noexcept { return m_dialect; }
+};
+
+#endif // CSV_H
@@ -0,0 +1,178 @@
+#ifndef GAPSTRING_H
+#define GAPSTRING_H
+
+#include "String.h"
+
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+/// \brief A string for editing, which keeps a gap of unused chars at the position of the last edit.
+///
+/// Inserting or erasing in a String moves every char behind the edit. A GapString only moves the
+/// chars between the previous edit and this one, to move the gap there, and then fills or widens
+/// the gap. Typing-like workloads, with many small edits close to each other, therefore cost O(1)
+/// amortized per edit instead of O(n).
+///
+/// The text is stored as the chars before the gap and the chars after it. GapString::view moves the
+/// gap to the end, after which the text is contiguous and viewing it is O(1) until the next edit
+/// somewhere else. GapString::release hands the buffer to a String without copying it.
+///
+/// Example
+///
+///     GapString editor(std::move(document));
+///     for (char c : typed)
+///         editor.insert(cursor++, c);
+///     document = editor.release();
+///
+class GapString
+{
+private:
+    // [0, m_gap_begin) are the chars before the gap, [m_gap_end, m_buffer.size()) the ones after it
+    std::vector<char> m_buffer;
+    std::size_t       m_gap_begin { 0 };
+    std::size_t       m_gap_end { 0 };
+
+    std::size_t gap_size() const noexcept { return m_gap_end - m_gap_begin; }
+    void        grow_gap(std::size_t n);
+    bool        overlaps(std::string_view chars) const noexcept;
+
+public:
+    /// \brief Returned by the find functions if nothing was found.
+    static constexpr std::size_t npos = std::size_t(-1);
+    /// \brief Size of the gap a GapString grows by at least.
+    static constexpr std::size_t min_gap = 64;
+
+    /// \brief Random access iterator over the chars, skipping the gap.
+    class ConstIterator
+    {
+    private:
+        const GapString* m_string { nullptr };
+        std::size_t      m_index { 0 };
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = char;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = char;
+
+        ConstIterator() = default;
+        ConstIterator(const GapString* string, std::size_t index)
+            : m_string(string)
+            , m_index(index) { }
+
+        char operator*() const { return (*m_string)[m_index]; }
+        char operator[](difference_type n) const { return (*m_string)[m_index + n]; }
+
+        ConstIterator& operator++() {
+            ++m_index;
+            return *this;
+        }
+        ConstIterator operator++(int) {
+            auto copy = *this;
+            ++m_index;
+            return copy;
+        }
+        ConstIterator& operator--() {
+            --m_index;
+            return *this;
+        }
+        ConstIterator operator--(int) {
+            auto copy = *this;
+            --m_index;
+            return copy;
+        }
+        ConstIterator& operator+=(difference_type n) {
+            m_index += n;
+            return *this;
+        }
+        ConstIterator& operator-=(difference_type n) {
+            m_index -= n;
+            return *this;
+        }
+        ConstIterator   operator+(difference_type n) const { return ConstIterator(m_string, m_index + n); }
+        ConstIterator   operator-(difference_type n) const { return ConstIterator(m_string, m_index - n); }
+        difference_type operator-(const ConstIterator& other) const { return difference_type(m_index) - difference_type(other.m_index); }
+
+        bool operator==(const ConstIterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const ConstIterator& other) const { return m_index != other.m_index; }
+        bool operator<(const ConstIterator& other) const { return m_index < other.m_index; }
+        bool operator>(const ConstIterator& other) const { return m_index > other.m_index; }
+        bool operator<=(const ConstIterator& other) const { return m_index <= other.m_index; }
+        bool operator>=(const ConstIterator& other) const { return m_index >= other.m_index; }
+    };
+
+    /// \brief New empty string.
+    GapString() = default;
+    /// \brief New string with a copy of `chars`, and the gap at the end.
+    explicit GapString(std::string_view chars);
+    /// \brief New string with a copy of `chars`, and the gap at the end.
+    explicit GapString(const char* chars)
+        : GapString(std::string_view(chars)) { }
+    /// \brief New string taking over the buffer of `string`, without copying. Its spare capacity
+    /// becomes the gap.
+    explicit GapString(String&& string) noexcept;
+
+    /// \brief Amount of chars, not counting the gap.
+    std::size_t size() const noexcept { return m_buffer.size() - gap_size(); }
+    /// \brief True if there are no chars.
+    bool empty() const noexcept { return size() == 0; }
+    /// \brief Offset of the gap, which is where the last edit happened.
+    std::size_t gap_position() const noexcept { return m_gap_begin; }
+
+    /// \brief The char at `i`. No bounds checking is done.
+    char operator[](std::size_t i) const noexcept { return m_buffer[i < m_gap_begin ? i : i + gap_size()]; }
+    /// \brief The char at `i`.
+    /// \throw std::out_of_range if `i` is an invalid index
+    char at(std::size_t i) const;
+
+    ConstIterator begin() const noexcept { return ConstIterator(this, 0); }
+    ConstIterator end() const noexcept { return ConstIterator(this, size()); }
+
+    /// \brief The chars before the gap.
+    std::string_view before_gap() const noexcept { return std::string_view(m_buffer.data(), m_gap_begin); }
+    /// \brief The chars after the gap.
+    std::string_view after_gap() const noexcept {
+        return std::string_view(m_buffer.data() + m_gap_end, m_buffer.size() - m_gap_end);
+    }
+
+    /// \brief All chars as one view, moving the gap to the end first. O(1) if it is there already.
+    /// The view is invalidated by any edit.
+    std::string_view view();
+
+    /// \brief Moves the gap to `position`, moving the chars in between.
+    /// \throw std::out_of_range if `position` is past the end.
+    void move_gap(std::size_t position);
+
+    /// \brief Inserts `chars` at `position`. `chars` may point into this string.
+    /// \throw std::out_of_range if `position` is past the end.
+    void insert(std::size_t position, std::string_view chars);
+    /// \brief Inserts `c` at `position`.
+    /// \throw std::out_of_range if `position` is past the end.
+    void insert(std::size_t position, char c) { insert(position, std::string_view(&c, 1)); }
+    /// \brief Erases `count` chars starting at `position`.
+    /// \throw std::out_of_range if the chars are not all within the string.
+    void erase(std::size_t position, std::size_t count = 1);
+    /// \brief Removes all chars. Keeps the buffer, which all becomes gap.
+    void clear() noexcept;
+
+    /// \brief Index of the first `c` at or after `from`, or GapString::npos.
+    std::size_t find(char c, std::size_t from = 0) const noexcept;
+    /// \brief Index of the first occurance of `needle` at or after `from`, including one spanning
+    /// the gap, or GapString::npos. An empty needle is found at `from`.
+    std::size_t find(std::string_view needle, std::size_t from = 0) const;
+
+    /// \brief A copy of the chars as a String, with one allocation.
+    String to_string() const;
+    /// \brief Moves the gap to the end and hands the buffer to a String, without copying the chars.
+    /// Leaves this GapString empty.
+    String release();
+
+    /// \brief Whether both have the same chars, wherever their gaps are.
+    bool operator==(std::string_view other) const noexcept;
+    /// \brief Whether the chars differ.
+    bool operator!=(std::string_view other) const noexcept { return !(*this == other); }
+};
+
+#endif // GAPSTRING_H
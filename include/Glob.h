@@ -0,0 +1,141 @@
+#ifndef GLOB_H
+#define GLOB_H
+
+#include "String.h"
+
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/// \brief A wildcard pattern like `*.log` or `api/*/v?/users`, compiled once and matched many times.
+///
+/// Supported syntax:
+///
+/// * `?` matches any single char except `'/'`.
+/// * `*` matches any sequence of chars not containing `'/'`, including the empty one.
+/// * `**` matches any sequence of chars, including `'/'`. As a whole path component (`a/**/b`), it
+///   matches whole components only, or none at all, so `a/**/b` matches `a/b` as well as `a/x/y/b`
+///   but not `a/xb`.
+/// * `[abc]`, `[a-z]` match one of the listed chars, `[!abc]` or `[^abc]` one that is not listed.
+///   Neither ever matches `'/'`. A `]` right after the opening bracket is part of the set.
+/// * `\` makes the following char literal.
+///
+/// The whole text must match, not only a part of it. Matching runs in time linear in the length of
+/// the text (times the length of the pattern / 64), no matter how many stars the pattern has.
+///
+/// Example
+///
+///     GlobPattern logs("/var/log/**/*.log");
+///     logs.matches("/var/log/nginx/access.log"); // -> true
+///
+class GlobPattern
+{
+private:
+    enum class Kind : std::uint8_t
+    {
+        Literal,
+        AnyChar,
+        Set,
+        Star,
+        DoubleStar,
+        // "**/" is two states: entering it, from where it may be skipped entirely, and being inside
+        // it, which is only left on a '/'
+        AnyDirectories,
+        InDirectories,
+    };
+
+    struct Token {
+        Kind          kind;
+        unsigned char c;
+        std::size_t   set;
+    };
+
+    String                     m_pattern;
+    std::vector<Token>         m_tokens;
+    std::vector<bool>          m_sets; // 256 entries per set
+    // chars which behave the same in every token share a class
+    std::uint8_t               m_char_class[256] {};
+    std::size_t                m_words { 0 };
+    // per class: tokens which consume the char and advance, and tokens which consume it and stay
+    std::vector<std::uint64_t> m_advance;
+    std::vector<std::uint64_t> m_stay;
+    // tokens which may match nothing, and tokens which may skip the token behind them as well
+    std::vector<std::uint64_t> m_optional;
+    std::vector<std::uint64_t> m_skip_two;
+    String                     m_prefix;
+    String                     m_suffix;
+    std::size_t                m_min_size { 0 };
+    bool                       m_literal { false };
+    // prefix * suffix, where * is a single star: only needs a check for '/'
+    bool                       m_single_star { false };
+
+    void compile();
+    void build_automaton();
+    bool token_consumes(const Token& token, unsigned char c) const;
+    bool run_automaton(std::string_view text) const;
+
+    friend class GlobSet;
+
+public:
+    /// \brief Compiles `pattern`.
+    /// \throw std::invalid_argument if the pattern is malformed, like an unterminated `[`.
+    explicit GlobPattern(const String& pattern);
+    /// \brief Compiles `pattern`.
+    /// \throw std::invalid_argument if the pattern is malformed, like an unterminated `[`.
+    explicit GlobPattern(std::string_view pattern);
+    /// \brief Compiles `pattern`.
+    /// \throw std::invalid_argument if the pattern is malformed, like an unterminated `[`.
+    explicit GlobPattern(const char* pattern);
+
+    /// \brief Whether the whole `text` matches this pattern.
+    bool matches(std::string_view text) const;
+
+    /// \brief The pattern this was compiled from.
+    const String& pattern() const noexcept { return m_pattern; }
+
+    /// \brief Whether any of the patterns matches `text`. For repeated use, prefer GlobSet.
+    static bool match_any(const std::vector<GlobPattern>& patterns, std::string_view text);
+};
+
+/// \brief A set of GlobPatterns which are matched against a text together.
+///
+/// Patterns without any wildcards are looked up in a hash table, the others are checked in the order
+/// they were added, after cheap prefix, suffix and length checks.
+class GlobSet
+{
+private:
+    std::vector<GlobPattern>                          m_patterns;
+    std::vector<std::size_t>                          m_wildcard_patterns;
+    // hash of the literal -> index of the pattern
+    std::unordered_multimap<std::size_t, std::size_t> m_literal_patterns;
+
+public:
+    /// \brief Returned by GlobSet::first_match if no pattern matches.
+    static constexpr std::size_t npos = std::size_t(-1);
+
+    GlobSet() = default;
+    /// \brief New set of all `patterns`. See GlobSet::add.
+    explicit GlobSet(const std::vector<String>& patterns);
+
+    /// \brief Compiles and adds `pattern`.
+    /// \return The index of the pattern, as returned by first_match.
+    /// \throw std::invalid_argument if the pattern is malformed.
+    std::size_t add(std::string_view pattern);
+
+    /// \brief Whether any pattern in the set matches `text`.
+    bool match_any(std::string_view text) const;
+    /// \brief Index of the pattern added first that matches `text`, or GlobSet::npos.
+    std::size_t first_match(std::string_view text) const;
+    /// \brief Indices of all patterns matching `text`, in ascending order.
+    std::vector<std::size_t> all_matches(std::string_view text) const;
+
+    /// \brief The pattern at `index`.
+    const GlobPattern& operator[](std::size_t index) const { return m_patterns[index]; }
+    /// \brief Amount of patterns in the set.
+    std::size_t size() const noexcept { return m_patterns.size(); }
+    /// \brief True if the set has no patterns.
+    bool empty() const noexcept { return m_patterns.empty(); }
+};
+
+#endif // GLOB_H
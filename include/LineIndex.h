@@ -0,0 +1,116 @@
+#ifndef LINEINDEX_H
+#define LINEINDEX_H
+
+#include "String.h"
+
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+/// \brief Positions of the lines of a text, for finding line N or the line of an offset without
+/// scanning the text.
+///
+/// Built once with a vectorized scan for `'\n'`, and then kept up to date through edits: editing the
+/// text through LineIndex::insert and LineIndex::erase, or reporting edits made elsewhere with
+/// LineIndex::inserted and LineIndex::erased, only rescans the inserted chars. Lines are separated
+/// by `'\n'`, so a text with `k` newlines has `k + 1` lines, the last of which may be empty.
+///
+/// The newline offsets are kept in blocks of a few thousand. An edit updates the block it touches
+/// and shifts the blocks behind it by adjusting one offset per block, so besides rescanning the
+/// inserted chars it costs O(lines / block_size) rather than O(lines).
+///
+/// Example
+///
+///     String    log = read_log();
+///     LineIndex lines(log);
+///     auto      start = lines.line_start(1000); // offset of the first char of line 1000
+///     lines.insert(log, start, "inserted line\n");
+///
+class LineIndex
+{
+private:
+    struct Block {
+        // added to every entry of `newlines`, modulo 2^64, which lets blocks behind an erase move
+        // below their own entries
+        std::size_t              base;
+        std::vector<std::size_t> newlines;
+
+        std::size_t first() const noexcept { return base + newlines.front(); }
+        std::size_t last() const noexcept { return base + newlines.back(); }
+    };
+
+    // never empty blocks, in text order
+    std::vector<Block>       m_blocks;
+    // m_first[b] is the index of the first newline of block b, m_first.back() the amount of newlines
+    std::vector<std::size_t> m_first { 0 };
+    std::size_t              m_size { 0 };
+
+    std::size_t block_at_or_after(std::size_t offset) const noexcept;
+    void        rebalance(std::size_t block);
+    void        renumber(std::size_t from_block);
+
+public:
+    /// \brief Newlines per block. Blocks are split into blocks of this size once twice as large.
+    static constexpr std::size_t block_size = 4096;
+
+    /// \brief Index of an empty text, with one empty line.
+    LineIndex() = default;
+    /// \brief Index of `text`.
+    explicit LineIndex(std::string_view text) { rebuild(text); }
+
+    /// \brief Forgets all edits and indexes `text` from scratch.
+    void rebuild(std::string_view text);
+
+    /// \brief Amount of lines, which is one more than the amount of newlines.
+    std::size_t line_count() const noexcept { return m_first.back() + 1; }
+    /// \brief Size of the indexed text.
+    std::size_t text_size() const noexcept { return m_size; }
+    /// \brief Amount of blocks the newlines are kept in, at most 2 * block_size newlines each.
+    std::size_t block_count() const noexcept { return m_blocks.size(); }
+
+    /// \brief Offset of the first char of line `line`, counting from 0, in O(log(lines / block_size)).
+    /// \throw std::out_of_range if there is no such line.
+    std::size_t line_start(std::size_t line) const;
+    /// \brief Offset one past the last char of line `line`, which is its `'\n'` or the end of the text.
+    /// \throw std::out_of_range if there is no such line.
+    std::size_t line_end(std::size_t line) const;
+    /// \brief Line that the char at `offset` is in, counting from 0, in O(log lines). A `'\n'` is
+    /// part of the line it ends. `offset` may be the size of the text, which is in the last line.
+    /// \throw std::out_of_range if `offset` is past the end of the text.
+    std::size_t line_of(std::size_t offset) const;
+    /// \brief Column of the char at `offset` within its line, counting from 0.
+    /// \throw std::out_of_range if `offset` is past the end of the text.
+    std::size_t column_of(std::size_t offset) const { return offset - line_start(line_of(offset)); }
+
+    /// \brief Updates the index after `chars` were inserted into the text at `offset`.
+    /// \throw std::out_of_range if `offset` is past the end of the text.
+    void inserted(std::size_t offset, std::string_view chars);
+    /// \brief Updates the index after `count` chars were erased from the text at `offset`.
+    /// \throw std::out_of_range if the chars are not all within the text.
+    void erased(std::size_t offset, std::size_t count);
+
+    /// \brief Inserts `chars` into `text` at `offset` and updates the index. `text` must be the
+    /// indexed text, and `chars` may point into it.
+    /// \throw std::out_of_range if `offset` is past the end of the text.
+    template<class CheckPolicy>
+    void insert(BasicString<CheckPolicy>& text, std::size_t offset, std::string_view chars) {
+        if (offset > text.size())
+            throw std::out_of_range("line index offset out of range");
+        text.insert_chars(offset, chars);
+        inserted(offset, text.view().substr(offset, chars.size()));
+    }
+    /// \brief Erases `count` chars from `text` at `offset` and updates the index. `text` must be the
+    /// indexed text.
+    /// \throw std::out_of_range if the chars are not all within the text.
+    template<class CheckPolicy>
+    void erase(BasicString<CheckPolicy>& text, std::size_t offset, std::size_t count) {
+        if (offset > text.size() || count > text.size() - offset)
+            throw std::out_of_range("line index offset out of range");
+        if (count == 0)
+            return;
+        text.erase(text.begin() + std::ptrdiff_t(offset), count);
+        erased(offset, count);
+    }
+};
+
+#endif // LINEINDEX_H
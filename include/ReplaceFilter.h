@@ -0,0 +1,101 @@
+#ifndef REPLACEFILTER_H
+#define REPLACEFILTER_H
+
+#include "String.h"
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/// \brief Replaces patterns in a stream of any size, reading and writing it in chunks.
+///
+/// Where String::replace needs the whole text in memory, a ReplaceFilter holds one chunk, its
+/// output, and fewer chars than the longest pattern carried over from one chunk to the next, so a
+/// match split across two chunks is still found.
+///
+/// All replacements are applied in one pass from front to back, and replaced text is never searched
+/// again. Where several patterns match, the one starting first wins, and of those starting at the
+/// same position the longest.
+///
+/// Example
+///
+///     ReplaceFilter filter({ { "colour", "color" }, { "centre", "center" } });
+///     const auto    stats = filter.run(std::cin, std::cout);
+///     std::cerr << stats.matches << " replaced at " << stats.bytes_per_second() / 1e6 << " MB/s\n";
+///
+/// Chunks may also be fed by hand with ReplaceFilter::process and ReplaceFilter::finish.
+class ReplaceFilter
+{
+public:
+    /// \brief What a ReplaceFilter has done so far.
+    struct Stats {
+        /// \brief Chars read from the input.
+        std::uint64_t              bytes_read { 0 };
+        /// \brief Chars written to the output.
+        std::uint64_t              bytes_written { 0 };
+        /// \brief Total amount of replacements.
+        std::uint64_t              matches { 0 };
+        /// \brief Amount of replacements per pattern, in the order they were given.
+        std::vector<std::uint64_t> matches_per_pattern;
+        /// \brief Wall time spent in ReplaceFilter::run.
+        double                     seconds { 0 };
+
+        /// \brief Input throughput of ReplaceFilter::run.
+        double bytes_per_second() const noexcept { return seconds > 0 ? double(bytes_read) / seconds : 0; }
+    };
+
+    /// \brief Chunk size used unless another one is given.
+    static constexpr std::size_t default_chunk_size = 64 * 1024;
+
+private:
+    std::vector<String>      m_from;
+    std::vector<String>      m_to;
+    std::size_t              m_longest { 0 };
+    std::size_t              m_chunk_size;
+    // the tail of the input which may be the start of a match continuing in the next chunk
+    std::string              m_carry;
+    std::string              m_window;
+    std::string              m_output;
+    // per pattern, where it matches next in the data being scanned
+    std::vector<std::size_t> m_next;
+    Stats                    m_stats;
+
+    std::size_t scan(std::string_view data, std::size_t from, std::size_t safe_end);
+    std::size_t safe_end(std::size_t size) const noexcept { return size >= m_longest - 1 ? size - (m_longest - 1) : 0; }
+
+public:
+    /// \brief Filter replacing `from` with `to`.
+    /// \throw std::invalid_argument if `from` is empty or `chunk_size` is 0.
+    ReplaceFilter(std::string_view from, std::string_view to, std::size_t chunk_size = default_chunk_size);
+    /// \brief Filter replacing the first of each pair with the second.
+    /// \throw std::invalid_argument if there are no replacements, a pattern is empty or `chunk_size` is 0.
+    explicit ReplaceFilter(const std::vector<std::pair<String, String>>& replacements, std::size_t chunk_size = default_chunk_size);
+
+    /// \brief Feeds the next `chunk` of the input.
+    /// \return The output that is final so far, valid until the next call.
+    std::string_view process(std::string_view chunk);
+    /// \brief Ends the input.
+    /// \return The rest of the output, valid until the next call.
+    std::string_view finish();
+
+    /// \brief Filters all of `in` into `out`, chunk by chunk, and finishes.
+    ///
+    /// Stops early if `out` fails, leaving its state set.
+    /// \return The stats of this filter, including earlier runs.
+    const Stats& run(std::istream& in, std::ostream& out);
+    /// \brief Filters everything readable from the file descriptor `in` into `out`, and finishes.
+    /// \return The stats of this filter, including earlier runs.
+    /// \throw std::system_error if reading or writing fails.
+    const Stats& run(int in, int out);
+
+    /// \brief What this filter has done so far.
+    const Stats& stats() const noexcept { return m_stats; }
+    /// \brief Forgets any carried over input and resets the stats, to filter another input.
+    void reset();
+};
+
+#endif // REPLACEFILTER_H
@@ -7,8 +7,83 @@
 #include <vector>
 #include <cstring>
 #include <sstream>
+#include <string_view>
+#include <initializer_list>
+
+#include "StringFwd.h"
+#include "StringInstrument.h"
+
+class ConstString;
+class GapString;
+class LineIndex;
+class StringList;
+class Template;
+
+/// \brief The parts of BasicString which do not depend on its check policy.
+struct StringBase {
+    /// \brief The alphabet used by the Base64 functions.
+    enum class Base64Alphabet
+    {
+        /// \brief RFC 4648 section 4, using `+` and `/`.
+        Standard,
+        /// \brief RFC 4648 section 5, URL and filename safe, using `-` and `_`.
+        Url,
+    };
+
+    /// \brief A match found by String::fuzzy_find.
+    struct FuzzyMatch {
+        /// \brief Index one past the last char of the match.
+        std::size_t end;
+        /// \brief Edits needed to turn the match into the pattern.
+        std::size_t errors;
+    };
+
+    /// \brief Specifies the formatting of a String::format operation.
+    ///
+    /// Example
+    ///
+    ///     String::Format fmt;
+    ///     fmt.precision = 3;
+    ///     String my_string = String::format(fmt, 2.1337);
+    ///
+    /// will result in
+    ///
+    ///     my_string = "2.13"
+    ///
+    struct Format {
+        enum Align : bool
+        {
+            Left,
+            Right
+        };
+
+        enum Base
+        {
+            Oct = 8,
+            Dec = 10,
+            Hex = 16,
+        };
+
+        /// \brief The precision (i.e. how many digits are generated) of floating
+        /// point numbers output with this format. See `std::ios::precision`.
+        int precision { 6 };
+        /// \brief The base used to display integer types. See `std::ios::base`.
+        Base base { Base::Dec };
+        /// \brief Alignment used with width. See `std::ios::left` and `std::ios::right`.
+        Align alignment { Align::Left };
+        /// \brief Width used on some format operations. See `std::ios::width`.
+        int width { 0 };
+        /// \brief Filler used to fill whitespace in width formats. See `std::ios::fill`.
+        char fill { ' ' };
 
-/// \brief The String class represents a not-null-terminated string.
+        friend std::ostream& operator<<(std::ostream&, const Format&);
+    };
+
+protected:
+    static std::ostream& write_to(std::ostream& os, std::string_view chars);
+};
+
+/// \brief The String class represents a string of chars, which may contain `'\0'` like any other char.
 /// \author `lionkor` (Lion Kortlepel)
 ///
 /// A String class without many of the inconsistencies that `std::string` brings, and many helper
@@ -17,13 +92,26 @@
 /// Implemented as a wrapper around a `std::vector<char>` for safety, simplicity and speed.
 /// This means that any `<algorithm>` calls should work as expected.
 ///
-/// \attention String is \b not null-terminated. If a null-terminated string is needed, it's very simple
-/// to convert to a `std::string` or c-string via `String::to_c_string` and `String::to_std_string`.
-class String
+/// A `'\0'` is kept just past the last char, without being part of the string, so String::c_str
+/// hands the chars to C APIs without copying. If the string itself contains `'\0'`, C APIs will
+/// only see the chars before the first one.
+///
+/// `CheckPolicy` decides what happens to invalid iterators and indices: String (Checked) throws,
+/// UncheckedString (Unchecked) only `assert`s, so hot loops pay nothing for the checks in release
+/// builds. Both share all other behaviour, and convert into each other through `view()`. Trivial
+/// accessors are defined in this header so they inline, everything else is compiled once in the
+/// library for both policies.
+template<class CheckPolicy>
+class BasicString : public StringBase
 {
 private:
+    // either empty, for an empty string which never allocated, or the chars followed by a '\0'
     std::vector<char> m_chars;
 
+    friend class GapString;
+    friend class LineIndex;
+    friend class Template;
+
 public:
     /// \brief Iterators used to iterate over the String.
     /// \attention Do *not* rely on these iterators being aliases for
@@ -35,51 +123,89 @@ public:
     using ConstReverseIterator = std::vector<char>::const_reverse_iterator;
 
     /// \brief New empty string, equivalent to `""`.
-    String();
+    BasicString();
     /// \brief New string from nullptr -> empty string.
-    String(std::nullptr_t);
+    BasicString(std::nullptr_t);
     /// \brief New string with only the char `c`.
-    explicit String(char c);
+    explicit BasicString(char c);
     /// \brief New string with cstr as content
-    String(const char* cstr);
+    BasicString(const char* cstr);
     /// \brief New string from another string's iterators.
-    String(ConstIterator from, ConstIterator to);
-
-    String(const String&) = default;
-    String(String&&)      = default;
-    String& operator=(const String&) = default;
+    BasicString(ConstIterator from, ConstIterator to);
+    /// \brief New string with a copy of the chars of the view.
+    explicit BasicString(std::string_view view);
+
+#if defined(STRING_INSTRUMENT)
+    BasicString(const BasicString&);
+    BasicString(BasicString&&) noexcept;
+    BasicString& operator=(const BasicString&);
+    BasicString& operator=(BasicString&&) noexcept;
+#else
+    BasicString(const BasicString&) = default;
+    BasicString(BasicString&&)      = default;
+    BasicString& operator=(const BasicString&) = default;
+    BasicString& operator=(BasicString&&) = default;
+#endif
 
     /// \brief Implicit conversion to std::string allowed.
     operator std::string() const;
+    /// \brief Implicit conversion to a non-owning std::string_view of the chars.
+    /// The view is invalidated by any operation that may invalidate iterators.
+    operator std::string_view() const noexcept;
 
     /// \brief Begin iterator. Points to the first char in the string.
-    Iterator begin();
+    Iterator begin() noexcept { return m_chars.begin(); }
     /// \brief Const begin iterator. Points to the first char in the string.
-    ConstIterator begin() const;
+    ConstIterator begin() const noexcept { return m_chars.begin(); }
     /// \brief End iterator. points at the position past the end of the string.
-    Iterator end();
+    Iterator end() noexcept { return m_chars.begin() + size(); }
     /// \brief Const end iterator. points at the position past the end of the string.
-    ConstIterator end() const;
+    ConstIterator end() const noexcept { return m_chars.begin() + size(); }
     /// \brief Accesses the character at position `i` in the string.
-    /// \throw std::out_of_range if `i` is an invalid index
-    char& at(std::size_t i);
+    /// \throw std::out_of_range if `i` is an invalid index and the check policy is Checked
+    char& at(std::size_t i) {
+        CheckPolicy::check_index(i < size());
+        return m_chars[i];
+    }
     /// \brief Accesses the character at position i in the string.
-    /// \throw std::out_of_range if `i` is an invalid index
-    char at(std::size_t i) const;
+    /// \throw std::out_of_range if `i` is an invalid index and the check policy is Checked
+    char at(std::size_t i) const {
+        CheckPolicy::check_index(i < size());
+        return m_chars[i];
+    }
+    /// \brief Accesses the character at position `i` in the string. Only asserts that `i` is valid,
+    /// whatever the check policy, like `std::vector::operator[]`.
+    char& operator[](std::size_t i) noexcept {
+        assert(i < size() && "String index out of range");
+        return m_chars[i];
+    }
+    /// \brief Accesses the character at position `i` in the string. Only asserts that `i` is valid,
+    /// whatever the check policy, like `std::vector::operator[]`.
+    char operator[](std::size_t i) const noexcept {
+        assert(i < size() && "String index out of range");
+        return m_chars[i];
+    }
     /// \brief True if the string is empty, i.e. has length 0
-    bool empty() const noexcept;
+    bool empty() const noexcept { return m_chars.size() <= 1; }
     /// \brief Size or length of the string.
-    std::size_t size() const noexcept;
+    std::size_t size() const noexcept { return m_chars.size() - !m_chars.empty(); }
     /// \brief Length or size of the string.
-    std::size_t length() const noexcept;
+    std::size_t length() const noexcept { return size(); }
 
     /// \brief A unique_ptr managed char[] containing a copy of the data of the string,
-    /// guaranteed to be null-terminated.
+    /// guaranteed to be null-terminated. Prefer String::c_str, which does not copy.
     std::unique_ptr<char[]> to_c_string() const;
+    /// \brief The chars of this string, followed by a `'\0'`, for passing to C APIs. Never copies or
+    /// allocates. The pointer is invalidated by any operation that may invalidate iterators.
+    const char* c_str() const noexcept { return m_chars.empty() ? "" : m_chars.data(); }
     /// \brief A copy of this string represented as a std::string.
     std::string to_std_string() const;
+    /// \brief A non-owning view of the chars of this string. Does not copy.
+    /// The view is invalidated by any operation that may invalidate iterators.
+    std::string_view view() const noexcept { return std::string_view(m_chars.data(), size()); }
 
-    /// \brief Clears the contents of the string, resulting string will be the empty string.
+    /// \brief Clears the contents of the string, resulting string will be the empty string. Keeps the
+    /// capacity, and String::data stays followed by a `'\0'`.
     void clear() noexcept;
 
     /// \brief Inserts a char before the position pointed to by the iterator. May invalidate
@@ -87,7 +213,7 @@ public:
     void insert(ConstIterator iter, char c);
     /// \brief Inserts the string before the position pointed to by the iterator. May invalidate
     /// iterators.
-    void insert(ConstIterator iter, const String& s);
+    void insert(ConstIterator iter, const BasicString& s);
     /// \brief Inserts the part of the string specified by the begin and end iterators
     /// before the position pointed to by the "iter" iterator. May invalidate iterators.
     void insert(ConstIterator iter, ConstIterator begin, ConstIterator end);
@@ -100,9 +226,9 @@ public:
     void erase(ConstIterator iter, std::size_t n);
 
     /// \brief A copy of the chars between from and to, as a new string.
-    String substring(ConstIterator from, ConstIterator to) const;
+    BasicString substring(ConstIterator from, ConstIterator to) const;
     /// \brief A copy of the first n chars from start, as a new string.
-    String substring(ConstIterator start, std::size_t n) const;
+    BasicString substring(ConstIterator start, std::size_t n) const;
 
     /// \brief Finds the first occurance of char c in the string. Returns end() if nothing was
     /// found.
@@ -130,59 +256,344 @@ public:
     /// \brief Finds the first occurance of the string inside this string.
     /// \return String::Iterator pointing to the beginning of the found substring, or end() if
     /// nothing was found
-    Iterator find(const String&);
+    Iterator find(const BasicString&);
     /// \brief Finds the first occurance of the string inside this string.
     /// \return String::ConstIterator pointing to the beginning of the found substring, or end() if
     /// nothing was found
-    ConstIterator find(const String&) const;
+    ConstIterator find(const BasicString&) const;
     /// \brief Finds the first occurance of the string after `start` inside this string.
     /// \return String::Iterator pointing to the beginning of the found substring, or end() if
     /// nothing was found
-    Iterator find(const String&, Iterator start);
+    Iterator find(const BasicString&, Iterator start);
     /// \brief Finds the first occurance of the string after `start` inside this string.
     /// \return String::ConstIterator pointing to the beginning of the found substring, or end() if
     /// nothing was found
-    ConstIterator find(const String&, ConstIterator start) const;
+    ConstIterator find(const BasicString&, ConstIterator start) const;
+
+    /// \brief Finds the last occurance of char c in the string.
+    /// \return String::Iterator pointing to the found character, or end() if nothing was found.
+    Iterator rfind(char c);
+    /// \brief Finds the last occurance of char c in the string.
+    /// \return String::ConstIterator pointing to the found character, or end() if nothing was found.
+    ConstIterator rfind(char c) const;
+    /// \brief Finds the last occurance of `str` inside this string.
+    /// \return String::Iterator pointing to the beginning of the found substring, or end() if
+    /// nothing was found
+    Iterator rfind(std::string_view str);
+    /// \brief Finds the last occurance of `str` inside this string.
+    /// \return String::ConstIterator pointing to the beginning of the found substring, or end() if
+    /// nothing was found
+    ConstIterator rfind(std::string_view str) const;
+
+    /// \brief Amount of times char c occurs in the string.
+    std::size_t count(char c) const noexcept;
+    /// \brief Amount of non-overlapping occurances of `str`, counted from the front.
+    /// \throw std::runtime_error if `str` is empty
+    std::size_t count(std::string_view str) const;
+    /// \brief Stores the index of every occurance of char c in `positions`, in ascending order.
+    ///
+    /// Replaces the previous contents of `positions`, but keeps its capacity, so reusing the same
+    /// vector avoids allocating once it is large enough.
+    /// \return The amount of occurances found.
+    std::size_t find_all(char c, std::vector<std::size_t>& positions) const;
+    /// \brief Stores the index of every non-overlapping occurance of `str` in `positions`, in
+    /// ascending order. See String::find_all(char, std::vector<std::size_t>&).
+    /// \throw std::runtime_error if `str` is empty
+    std::size_t find_all(std::string_view str, std::vector<std::size_t>& positions) const;
 
     /// \brief Whether this string contains the substring.
-    bool contains(const String&) const;
+    bool contains(const BasicString&) const;
     /// \brief Whether this string starts with the substring.
-    bool startswith(const String&) const;
+    bool startswith(const BasicString&) const;
     /// \brief Whether this string ends with the substring.
-    bool endswith(const String&) const;
+    bool endswith(const BasicString&) const;
 
     /// \brief Does a case-sensitive comparison between the chars of both strings.
     /// Same as String::operator==(const String&).
-    bool equals(const String&) const;
+    bool equals(const BasicString&) const;
     /// \brief Does a case-sensitive comparison between the chars of both strings.
-    bool operator==(const String&) const;
+    bool operator==(const BasicString&) const;
     /// \brief Does a case-sensitive comparison between the chars of both strings.
-    bool operator!=(const String&) const;
+    bool operator!=(const BasicString&) const;
+
+    /// \brief Compares the chars of both strings as unsigned bytes, like `std::memcmp`. A string
+    /// that is a prefix of the other sorts first.
+    /// \return A negative value if this string sorts before `other`, zero if they are equal, and a
+    /// positive value if it sorts after `other`.
+    int compare(std::string_view other) const noexcept {
+        const auto common = size() < other.size() ? size() : other.size();
+        const int  result = common == 0 ? 0 : std::memcmp(data(), other.data(), common);
+        if (result != 0)
+            return result;
+        return size() < other.size() ? -1 : size() > other.size() ? 1 : 0;
+    }
+    /// \brief Whether this string sorts before the other. See String::compare.
+    bool operator<(const BasicString& s) const noexcept { return compare(s.view()) < 0; }
+    /// \brief Whether this string sorts after the other. See String::compare.
+    bool operator>(const BasicString& s) const noexcept { return compare(s.view()) > 0; }
+    /// \brief Whether this string sorts before the other or equals it. See String::compare.
+    bool operator<=(const BasicString& s) const noexcept { return compare(s.view()) <= 0; }
+    /// \brief Whether this string sorts after the other or equals it. See String::compare.
+    bool operator>=(const BasicString& s) const noexcept { return compare(s.view()) >= 0; }
 
     /// \brief Appends the given string to this string.
-    String& operator+=(const String&);
+    BasicString& operator+=(const BasicString&);
     /// \brief Creates a new string by appending a string to this string.
-    String operator+(const String&) const;
+    BasicString operator+(const BasicString&) const;
 
     /// \brief Replaces \b all instances of `to_replace` with `replace_with` in the string.
     void replace(char to_replace, char replace_with);
-    /// \brief Replaces \b all instances of `to_replace` with `replace_with` in the string.
-    void replace(const String& to_replace, const String& replace_with);
-    /// \brief Replaces `n` instances of `to_replace` with `replace_with` in the string.
-    void replace(const String& to_replace, const String& replace_with, std::size_t n);
+    /// \brief Replaces \b all instances of `to_replace` with `replace_with` in the string, found from
+    /// left to right without overlapping, in one pass. Text produced by a replacement is not searched
+    /// again, so `String("aab").replace("ab", "b")` gives `"ab"`, not `"b"`.
+    ///
+    /// Runs in linear time, every char is copied at most once. Nothing is replaced if `to_replace` is
+    /// empty.
+    /// \throw std::invalid_argument if `replace_with` contains `to_replace`
+    void replace(const BasicString& to_replace, const BasicString& replace_with);
+    /// \brief Replaces the first `n` instances of `to_replace` with `replace_with` in the string, found
+    /// from left to right without overlapping and without searching replaced text again. See
+    /// String::replace(const String&, const String&).
+    void replace(const BasicString& to_replace, const BasicString& replace_with, std::size_t n);
 
     /// \brief Splits the String into substrings delimited by `delim`.
     ///
     /// \arg `delim` delimiter to be used
     /// \arg `expected_splits` how many parts are expected. Setting this to a reasonable
     /// amount will speed up the split operation as memory can be reserved beforehand.
-    std::vector<String> split(char delim, std::size_t expected_splits = 2) const;
+    std::vector<BasicString> split(char delim, std::size_t expected_splits = 2) const;
     /// \brief Splits the String into substrings delimited by the String `delim`.
     ///
     /// \arg `delim` delimiter string to be used
     /// \arg `expected_splits` how many parts are expected. Setting this to a reasonable
     /// amount will speed up the split operation as memory can be reserved beforehand.
-    std::vector<String> split(const String& delim, std::size_t expected_splits = 2) const;
+    std::vector<BasicString> split(const BasicString& delim, std::size_t expected_splits = 2) const;
+
+    /// \brief Splits the String into substrings delimited by `delim`, replacing the contents of `out`.
+    ///
+    /// Same result as String::split, but all parts are stored in one buffer, and the capacity of
+    /// `out` is reused. Splitting many inputs into the same StringList allocates only while it grows.
+    void split_into(StringList& out, char delim) const;
+    /// \brief Splits the String into substrings delimited by the String `delim`, replacing the contents
+    /// of `out`. See String::split_into(StringList&, char).
+    /// \throw std::runtime_error if `delim` is empty
+    void split_into(StringList& out, const BasicString& delim) const;
+
+    /// \brief Concatenates all elements of `range`, with `separator` between each two of them.
+    /// The inverse of String::split.
+    ///
+    /// Elements may be String, `std::string_view`, `std::string`, ConstString or `const char*`.
+    /// The size of the result is computed first, so exactly one allocation takes place.
+    ///
+    /// Example
+    ///
+    ///     std::vector<String> parts { "a", "b", "c" };
+    ///     String joined = String::join(", ", parts); // -> "a, b, c"
+    ///
+    template<class Range>
+    static BasicString join(const BasicString& separator, const Range& range) {
+        BasicString result;
+        join_to(result, separator, range);
+        return result;
+    }
+    /// \brief Concatenates `projection(element)` for all elements of `range`, with `separator` between
+    /// each two of them. See String::join.
+    ///
+    /// `projection` is called twice per element (once to compute the size, once to copy), four times if
+    /// a piece points into the string joined to, so it should be cheap and return one of the element
+    /// types String::join accepts, ideally a view.
+    template<class Range, class Projection>
+    static BasicString join(const BasicString& separator, const Range& range, Projection&& projection) {
+        BasicString result;
+        join_to(result, separator, range, std::forward<Projection>(projection));
+        return result;
+    }
+    /// \brief Concatenates all `pieces`, with `separator` between each two of them. See String::join.
+    static BasicString join(const BasicString& separator, std::initializer_list<std::string_view> pieces);
+
+    /// \brief Like String::join, but appends the result to `out`. Grows `out` at most once.
+    template<class Range>
+    static void join_to(BasicString& out, const BasicString& separator, const Range& range) {
+        join_to(out, separator, range, [](const auto& element) -> const auto& { return element; });
+    }
+    /// \brief Like String::join with a projection, but appends the result to `out`. Grows `out` at most once.
+    template<class Range, class Projection>
+    static void join_to(BasicString& out, const BasicString& separator, const Range& range, Projection&& projection) {
+        std::size_t total       = 0;
+        std::size_t count       = 0;
+        bool        overlapping = out.overlaps(separator.view());
+        auto        measure     = [&](std::string_view piece) {
+            total += piece.size();
+            overlapping = overlapping || out.overlaps(piece);
+        };
+        for (const auto& element : range) {
+            measure(piece_view(projection(element)));
+            ++count;
+        }
+        if (count == 0)
+            return;
+        if (overlapping) {
+            // growing `out` would move or overwrite chars that are still to be copied
+            BasicString joined;
+            join_to(joined, separator, range, projection);
+            out += joined;
+            return;
+        }
+        total += separator.size() * (count - 1);
+        out.reserve(out.size() + total);
+        char* write = out.append_uninitialized(total);
+        auto  copy  = [&write](std::string_view chars) {
+            if (!chars.empty())
+                std::memcpy(write, chars.data(), chars.size());
+            write += chars.size();
+        };
+        bool first = true;
+        for (const auto& element : range) {
+            if (!first)
+                copy(separator.view());
+            first = false;
+            copy(piece_view(projection(element)));
+        }
+    }
+
+    /// \brief Converts all ASCII uppercase letters to lowercase, in place. Other chars are untouched.
+    void to_lower() noexcept;
+    /// \brief Converts all ASCII lowercase letters to uppercase, in place. Other chars are untouched.
+    void to_upper() noexcept;
+
+    /// \brief Removes leading and trailing ASCII whitespace, in place.
+    ///
+    /// Whitespace is `' '`, `'\t'`, `'\n'`, `'\v'`, `'\f'` and `'\r'`. Trailing whitespace is removed
+    /// by shrinking the size, so only leading whitespace causes chars to be moved (once).
+    void trim();
+    /// \brief Removes leading ASCII whitespace, in place. See String::trim.
+    void ltrim();
+    /// \brief Removes trailing ASCII whitespace, in place. Never moves any chars. See String::trim.
+    void rtrim();
+    /// \brief Removes all leading and trailing chars which appear in `chars`, in place.
+    void strip(const BasicString& chars);
+    /// \brief Replaces each run of ASCII whitespace with a single `' '`, in place.
+    ///
+    /// Combined with String::trim, this normalizes whitespace: `"  a \t\n b "` becomes `"a b"`.
+    void collapse_whitespace();
+
+    /// \brief A view of this string without leading and trailing ASCII whitespace. Does not copy.
+    std::string_view trim_view() const noexcept;
+    /// \brief A view of this string without leading ASCII whitespace. Does not copy.
+    std::string_view ltrim_view() const noexcept;
+    /// \brief A view of this string without trailing ASCII whitespace. Does not copy.
+    std::string_view rtrim_view() const noexcept;
+    /// \brief A view of this string without any leading and trailing chars which appear in `chars`.
+    /// Does not copy.
+    std::string_view strip_view(const BasicString& chars) const noexcept;
+
+    /// \brief The chars of this string as lowercase hexadecimal, two digits per char.
+    BasicString to_hex() const;
+    /// \brief Appends the chars of this string as lowercase hexadecimal to `out`. Grows `out` at most once.
+    void to_hex(BasicString& out) const;
+    /// \brief Decodes the hexadecimal digits in `hex`, case-insensitive.
+    /// \throw std::invalid_argument if `hex` has an odd length or contains a non-hex char. The
+    /// message contains the position of the offending char.
+    static BasicString from_hex(std::string_view hex);
+    /// \brief Decodes the hexadecimal digits in `hex` and appends them to `out`. Grows `out` at most once.
+    /// If an exception is thrown, `out` is left unchanged.
+    /// \throw std::invalid_argument, see String::from_hex(std::string_view)
+    static void from_hex(std::string_view hex, BasicString& out);
+    /// \brief Whether `hex` is valid input for String::from_hex.
+    static bool is_hex(std::string_view hex) noexcept;
+
+    /// \brief The chars of this string encoded as Base64.
+    /// \arg `padding` whether to pad the output with `=` to a multiple of four chars.
+    BasicString to_base64(Base64Alphabet alphabet = Base64Alphabet::Standard, bool padding = true) const;
+    /// \brief Appends the chars of this string encoded as Base64 to `out`. Grows `out` at most once.
+    void to_base64(BasicString& out, Base64Alphabet alphabet = Base64Alphabet::Standard, bool padding = true) const;
+    /// \brief Decodes the Base64 in `base64`. Padding is optional, but must be correct if present.
+    /// \throw std::invalid_argument if `base64` is not valid Base64 in the given alphabet. The message
+    /// contains the position of the offending char.
+    static BasicString from_base64(std::string_view base64, Base64Alphabet alphabet = Base64Alphabet::Standard);
+    /// \brief Decodes the Base64 in `base64` and appends it to `out`. Grows `out` at most once.
+    /// If an exception is thrown, `out` is left unchanged.
+    /// \throw std::invalid_argument, see String::from_base64(std::string_view, Base64Alphabet)
+    static void from_base64(std::string_view base64, BasicString& out, Base64Alphabet alphabet = Base64Alphabet::Standard);
+    /// \brief Whether `base64` is valid input for String::from_base64.
+    static bool is_base64(std::string_view base64, Base64Alphabet alphabet = Base64Alphabet::Standard) noexcept;
+
+    /// \brief The chars of this string escaped for use inside a JSON string literal.
+    ///
+    /// `"` and `\` are escaped with a backslash, control chars as `\n`, `\t` etc. or `\u00XX`. All other
+    /// chars, including non-ASCII UTF-8, are copied unchanged.
+    BasicString escape_json() const;
+    /// \brief Appends the chars of this string escaped for JSON to `out`. Grows `out` at most once.
+    void escape_json(BasicString& out) const;
+    /// \brief `chars` escaped for JSON, without copying if nothing needs escaping.
+    ///
+    /// Checks 16 chars at a time whether any need escaping. If none do, returns `chars` itself.
+    /// Otherwise replaces the contents of `buffer` with the escaped chars and returns a view of it.
+    static std::string_view escape_json(std::string_view chars, BasicString& buffer);
+    /// \brief Decodes the escape sequences of a JSON string literal, without the quotes. `\uXXXX`
+    /// sequences, including surrogate pairs, are decoded to UTF-8.
+    /// \throw std::invalid_argument if an escape sequence is invalid. The message contains its position.
+    static BasicString unescape_json(std::string_view json);
+    /// \brief Decodes the JSON escape sequences in `json` and appends the result to `out`. Grows
+    /// `out` at most once. If an exception is thrown, `out` is left unchanged.
+    /// \throw std::invalid_argument, see String::unescape_json(std::string_view)
+    static void unescape_json(std::string_view json, BasicString& out);
+
+    /// \brief The chars of this string escaped for HTML text and attribute values.
+    ///
+    /// `&`, `<`, `>`, `"` and `'` become `&amp;`, `&lt;`, `&gt;`, `&quot;` and `&#39;`.
+    BasicString escape_html() const;
+    /// \brief Appends the chars of this string escaped for HTML to `out`. Grows `out` at most once.
+    void escape_html(BasicString& out) const;
+    /// \brief `chars` escaped for HTML, without copying if nothing needs escaping. See
+    /// String::escape_json(std::string_view, BasicString&).
+    static std::string_view escape_html(std::string_view chars, BasicString& buffer);
+    /// \brief Decodes the HTML entities in `html`: the five produced by String::escape_html,
+    /// `&apos;`, and numeric ones like `&#233;` or `&#xE9;`, which are decoded to UTF-8.
+    ///
+    /// As browsers do, anything else starting with `&` is kept as it is.
+    static BasicString unescape_html(std::string_view html);
+    /// \brief Decodes the HTML entities in `html` and appends the result to `out`. Grows `out` at most once.
+    static void unescape_html(std::string_view html, BasicString& out);
+
+    /// \brief The chars of this string percent-encoded as in RFC 3986: all chars except ASCII
+    /// letters, digits, `-`, `.`, `_` and `~` become `%XX`, with uppercase hex digits.
+    BasicString percent_encode() const;
+    /// \brief Appends the chars of this string percent-encoded to `out`. Grows `out` at most once.
+    void percent_encode(BasicString& out) const;
+    /// \brief `chars` percent-encoded, without copying if nothing needs encoding. See
+    /// String::escape_json(std::string_view, BasicString&).
+    static std::string_view percent_encode(std::string_view chars, BasicString& buffer);
+    /// \brief Decodes the `%XX` sequences in `encoded`, case-insensitive. `+` is kept as it is.
+    /// \throw std::invalid_argument if a `%` is not followed by two hex digits. The message contains
+    /// its position.
+    static BasicString percent_decode(std::string_view encoded);
+    /// \brief Decodes the `%XX` sequences in `encoded` and appends the result to `out`. Grows `out`
+    /// at most once. If an exception is thrown, `out` is left unchanged.
+    /// \throw std::invalid_argument, see String::percent_decode(std::string_view)
+    static void percent_decode(std::string_view encoded, BasicString& out);
+
+    /// \brief Levenshtein distance to `other`: the least amount of single char insertions, deletions
+    /// and substitutions that turn one into the other. Chars are compared byte by byte.
+    ///
+    /// Runs in O(n * m / 64) time using the bit-parallel algorithm by Myers, as formulated by Hyyrö.
+    /// If the distance is larger than `max`, stops as soon as that is known and returns `max + 1`.
+    std::size_t edit_distance(std::string_view other, std::size_t max = std::size_t(-1)) const;
+    /// \brief Edit distances from `query` to each of the `candidates`, see String::edit_distance.
+    ///
+    /// Faster than calling String::edit_distance for each candidate, as the query is only prepared
+    /// once, and candidates whose length alone rules them out are skipped.
+    static std::vector<std::size_t> edit_distances(std::string_view query, const std::vector<BasicString>& candidates,
+                                                   std::size_t max = std::size_t(-1));
+    /// \brief Edit distances from `query` to each element of `candidates`, see String::edit_distance.
+    static std::vector<std::size_t> edit_distances(std::string_view query, const StringList& candidates,
+                                                   std::size_t max = std::size_t(-1));
+    /// \brief Finds all places where `pattern` occurs in this string with at most `k` errors.
+    ///
+    /// Reports one FuzzyMatch for every end position where some substring ending there is within
+    /// edit distance `k` of `pattern`, in ascending order. A single approximate occurrence usually
+    /// yields several adjacent end positions. Runs in O(n * m / 64) time.
+    std::vector<FuzzyMatch> fuzzy_find(std::string_view pattern, std::size_t k) const;
 
     /// \brief Grows the capacity to fit `size` many characters. Does not change the size of the string.
     ///
@@ -195,21 +606,24 @@ public:
     /// \brief Capacity of the string's underlying allocated memory.
     ///
     /// The String's size may grow up to this capacity without any reallocation taking place.
-    std::size_t capacity() const;
+    std::size_t capacity() const noexcept { return m_chars.capacity() == 0 ? 0 : m_chars.capacity() - 1; }
 
     /// \brief Shrinks capacity to be equal to size, thus freeing memory in some cases. Not
     /// guaranteed, as it's implementation dependent.
     void shrink_to_fit() noexcept;
 
     /// \brief Raw pointer to the data of this String.
-    /// Keep in mind that this is NOT null-terminated.
-    char* data() noexcept;
+    /// Followed by a `'\0'` unless the string is empty and has never allocated, see String::c_str.
+    /// Do not overwrite the `'\0'`.
+    char* data() noexcept { return m_chars.data(); }
     /// \brief Raw const pointer to the data of this String.
-    /// Keep in mind that this is NOT null-terminated.
-    const char* data() const noexcept;
+    /// Followed by a `'\0'` unless the string is empty and has never allocated, see String::c_str.
+    const char* data() const noexcept { return m_chars.data(); }
 
-    friend std::ostream& operator<<(std::ostream&, const String&);
-    friend std::istream& operator>>(std::istream& is, String& s);
+    /// \brief Writes the chars to `os`, honouring its width, fill and adjustment like a `std::string`.
+    friend std::ostream& operator<<(std::ostream& os, const BasicString& s) { return write_to(os, s.view()); }
+    /// \brief Appends everything left in `is` to `s`.
+    friend std::istream& operator>>(std::istream& is, BasicString& s) { return s.read_from(is); }
 
     /// \brief Constructs a string from non-string arguments.
     ///
@@ -221,61 +635,54 @@ public:
     /// Pass String::Format to specify floating point precision, width, fill
     /// chars, base, etc.
     template<class... Args>
-    static String format(Args&&... things) {
+    static BasicString format(Args&&... things) {
+        STRING_INSTRUMENT_SCOPE(StringOperation::Format, nullptr);
         std::stringstream s;
         return format(s, std::forward<Args>(things)...);
     }
 
-    /// \brief Specifies the formatting of a String::format operation.
-    ///
-    /// Example
-    ///
-    ///     String::Format fmt;
-    ///     fmt.precision = 3;
-    ///     String my_string = String::format(fmt, 2.1337);
-    ///
-    /// will result in
-    ///
-    ///     my_string = "2.13"
-    ///
-    struct Format {
-        enum Align : bool
-        {
-            Left,
-            Right
-        };
-
-        enum Base
-        {
-            Oct = 8,
-            Dec = 10,
-            Hex = 16,
-        };
 
-        /// \brief The precision (i.e. how many digits are generated) of floating
-        /// point numbers output with this format. See `std::ios::precision`.
-        int precision { 6 };
-        /// \brief The base used to display integer types. See `std::ios::base`.
-        Base base { Base::Dec };
-        /// \brief Alignment used with width. See `std::ios::left` and `std::ios::right`.
-        Align alignment { Align::Left };
-        /// \brief Width used on some format operations. See `std::ios::width`.
-        int width { 0 };
-        /// \brief Filler used to fill whitespace in width formats. See `std::ios::fill`.
-        char fill { ' ' };
+private:
+    std::istream& read_from(std::istream& is);
+
+    /// \brief Grows the string by `n` chars and returns a pointer to them, for the caller to fill.
+    char* append_uninitialized(std::size_t n);
+    /// \brief Inserts a copy of `chars` before the char at `index`. `chars` may point into this string.
+    void insert_chars(std::size_t index, std::string_view chars);
+    /// \brief Resizes the string to `n` chars, keeping the terminator behind them. New chars are `'\0'`.
+    void set_size(std::size_t n);
+    /// \brief Replaces the contents with the `n` chars at `chars`, which must not point into this string.
+    void assign_chars(const char* chars, std::size_t n);
+    /// \brief Grows the capacity to fit `n` chars and the terminator, at least doubling it if it grows.
+    void make_room(std::size_t n);
+    /// \brief Appends `chars` escaped by `Escaper` to `out`, where `first` is the index of the first
+    /// char that needs escaping. Defined and used in Escape.cpp.
+    template<class Escaper>
+    static void append_escaped(std::string_view chars, std::size_t first, BasicString& out);
+    /// \brief `chars` if `Escaper` escapes none of them, otherwise `buffer` set to the escaped chars.
+    template<class Escaper>
+    static std::string_view escaped_view(std::string_view chars, BasicString& buffer);
+    /// \brief Whether `chars` points into this string's buffer.
+    bool overlaps(std::string_view chars) const noexcept {
+        return !m_chars.empty() && chars.data() >= m_chars.data() && chars.data() < m_chars.data() + size();
+    }
 
-        friend std::ostream& operator<<(std::ostream&, const Format&);
-    };
+    template<class OtherPolicy>
+    static std::string_view piece_view(const BasicString<OtherPolicy>& s) noexcept { return s.view(); }
+    static std::string_view piece_view(std::string_view s) noexcept { return s; }
+    static std::string_view piece_view(const std::string& s) noexcept { return s; }
+    static std::string_view piece_view(const char* s) noexcept { return s ? std::string_view(s) : std::string_view(); }
+    static std::string_view piece_view(const ConstString& s) noexcept;
 
-private:
-    static String format(std::stringstream& is) {
-        String s;
+    static BasicString format(std::stringstream& is) {
+        BasicString s;
         is >> s;
+        STRING_INSTRUMENT_ADD(s.size(), s.capacity() != 0);
         return s;
     }
 
     template<class... Args, class T>
-    static String format(std::stringstream& is, T&& t, Args&&... things) {
+    static BasicString format(std::stringstream& is, T&& t, Args&&... things) {
         is << t;
         return format(is, std::forward<Args>(things)...);
     }
@@ -327,4 +734,9 @@ public:
     }
 };
 
+template<class CheckPolicy>
+inline std::string_view BasicString<CheckPolicy>::piece_view(const ConstString& s) noexcept {
+    return std::string_view(s, s.size());
+}
+
 #endif // STRING_H
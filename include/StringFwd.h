@@ -0,0 +1,43 @@
+#ifndef STRINGFWD_H
+#define STRINGFWD_H
+
+#include <cassert>
+#include <stdexcept>
+
+/// \brief Check policy of BasicString which validates iterators and indices and throws on misuse.
+///
+/// Invalid iterators passed to insert and erase throw `std::runtime_error`, invalid indices passed
+/// to `at` throw `std::out_of_range`. This is the policy of String.
+struct Checked {
+    static void check_iterator(bool valid) {
+        if (!valid)
+            throw std::runtime_error("iterator out of range");
+    }
+    static void check_index(bool valid) {
+        if (!valid)
+            throw std::out_of_range("String index out of range");
+    }
+};
+
+/// \brief Check policy of BasicString which only `assert`s, so the checks vanish with `NDEBUG`.
+///
+/// For hot loops whose iterators and indices are known to be valid. Misuse is undefined behaviour
+/// in release builds.
+struct Unchecked {
+    static void check_iterator([[maybe_unused]] bool valid) noexcept {
+        assert(valid && "iterator out of range");
+    }
+    static void check_index([[maybe_unused]] bool valid) noexcept {
+        assert(valid && "String index out of range");
+    }
+};
+
+template<class CheckPolicy>
+class BasicString;
+
+/// \brief The String type, which checks iterators and indices. See BasicString.
+using String = BasicString<Checked>;
+/// \brief A String which only asserts that iterators and indices are valid. See BasicString.
+using UncheckedString = BasicString<Unchecked>;
+
+#endif // STRINGFWD_H
@@ -0,0 +1,142 @@
+#ifndef STRINGIO_H
+#define STRINGIO_H
+
+#include "String.h"
+
+#include <climits>
+#include <ostream>
+#include <iterator>
+#include <string_view>
+#include <sys/uio.h>
+#include <type_traits>
+
+namespace detail {
+
+/// \brief Collects pieces into groups of `iovec`s and writes each full group with one `writev`.
+class IovecWriter
+{
+public:
+#if defined(IOV_MAX)
+    static constexpr std::size_t max_group = IOV_MAX < 1024 ? IOV_MAX : 1024;
+#else
+    static constexpr std::size_t max_group = 16; // _XOPEN_IOV_MAX, the least POSIX allows
+#endif
+
+private:
+    int         m_fd;
+    iovec       m_group[max_group];
+    std::size_t m_count { 0 };
+    std::size_t m_written { 0 };
+
+    void flush();
+
+public:
+    explicit IovecWriter(int fd) noexcept
+        : m_fd(fd) { }
+
+    void add(std::string_view piece) {
+        if (piece.empty())
+            return;
+        if (m_count == max_group)
+            flush();
+        m_group[m_count++] = iovec { const_cast<char*>(piece.data()), piece.size() };
+    }
+
+    std::size_t finish() {
+        flush();
+        return m_written;
+    }
+};
+
+/// \brief Whether `Range` is a range of elements convertible to `std::string_view`, as opposed to a
+/// single string, which is a range of chars.
+template<class Range>
+constexpr bool is_string_range = std::is_convertible_v<decltype(*std::begin(std::declval<const Range&>())), std::string_view>;
+
+}
+
+/// \brief Writes all of `data` to the file descriptor `fd`, retrying after partial writes and
+/// interruptions by signals.
+/// \return The amount of bytes written, which is always `data.size()`.
+/// \throw std::system_error if writing fails.
+std::size_t write_all(int fd, std::string_view data);
+
+/// \brief Writes all `pieces` back to back to the file descriptor `fd`, without copying them.
+///
+/// The pieces are handed to `writev` in groups of up to `IOV_MAX`, so writing many small Strings
+/// takes a handful of syscalls instead of one per String. Partial writes are continued where they
+/// stopped. `pieces` may be any range of elements convertible to `std::string_view`, like a
+/// `std::vector<String>` or a StringList.
+///
+/// Example
+///
+///     std::vector<String> lines = ...;
+///     write_all(STDOUT_FILENO, lines);
+///
+/// \return The amount of bytes written, which is always the sum of all piece sizes.
+/// \throw std::system_error if writing fails. Some of the pieces may have been written already.
+template<class Range, class = std::enable_if_t<detail::is_string_range<Range>>>
+std::size_t write_all(int fd, const Range& pieces) {
+    detail::IovecWriter writer(fd);
+    for (const auto& piece : pieces)
+        writer.add(std::string_view(piece));
+    return writer.finish();
+}
+
+/// \brief Writes all `pieces` back to back to `os`, without copying them and without any formatting.
+///
+/// The stream counterpart of write_all(int, const Range&): each piece goes straight to the stream
+/// buffer. Sets `std::ios::badbit` on `os` if not everything could be written.
+/// \return `os`
+template<class Range, class = std::enable_if_t<detail::is_string_range<Range>>>
+std::ostream& write_all(std::ostream& os, const Range& pieces) {
+    const std::ostream::sentry sentry(os);
+    if (!sentry)
+        return os;
+    for (const auto& piece : pieces) {
+        const std::string_view view(piece);
+        const auto             size = static_cast<std::streamsize>(view.size());
+        if (os.rdbuf()->sputn(view.data(), size) != size) {
+            os.setstate(std::ios::badbit);
+            break;
+        }
+    }
+    return os;
+}
+
+/// \brief A file mapped read-only into memory, for reading it as chars without copying it.
+///
+/// Pages are loaded by the OS as they are touched, so mapping even a very large file is cheap
+/// until it is read, and several processes mapping the same file share its pages.
+///
+/// Example
+///
+///     const MappedFile corpus("corpus.txt");
+///     std::string_view text = corpus.view(); // valid while `corpus` lives
+///
+class MappedFile
+{
+private:
+    const char* m_data { nullptr };
+    std::size_t m_size { 0 };
+
+public:
+    /// \brief No file.
+    MappedFile() = default;
+    /// \brief Maps the whole file at `path`. An empty file maps to an empty view.
+    /// \throw std::system_error if the file cannot be opened or mapped.
+    explicit MappedFile(const char* path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    /// \brief Unmaps the file. Views of it become invalid.
+    ~MappedFile();
+
+    /// \brief The contents of the file.
+    std::string_view view() const noexcept { return std::string_view(m_data, m_size); }
+    const char*      data() const noexcept { return m_data; }
+    std::size_t      size() const noexcept { return m_size; }
+};
+
+#endif // STRINGIO_H
@@ -0,0 +1,131 @@
+#ifndef STRING_INSTRUMENT_H
+#define STRING_INSTRUMENT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "StringFwd.h"
+
+/// \brief The String operations which are counted when compiled with `STRING_INSTRUMENT`.
+enum class StringOperation
+{
+    Construct,
+    Copy,
+    Move,
+    Insert,
+    Erase,
+    Find,
+    Split,
+    Replace,
+    Format,
+    Count,
+};
+
+/// \brief Counters of one StringOperation.
+struct StringOperationStats {
+    /// \brief How often the operation was called.
+    std::uint64_t calls { 0 };
+    /// \brief How many chars were copied or moved around in memory by the operation.
+    std::uint64_t bytes_copied { 0 };
+    /// \brief How many new buffers the operation allocated.
+    std::uint64_t allocations { 0 };
+    /// \brief How often the operation had to grow (or shrink) an existing buffer.
+    std::uint64_t reallocations { 0 };
+    /// \brief Total wall time spent in the operation, in nanoseconds.
+    std::uint64_t nanoseconds { 0 };
+};
+
+/// \brief Per-operation allocation, copy and timing statistics of all String operations.
+///
+/// Only collected if the library and all code including `String.h` is compiled with
+/// `STRING_INSTRUMENT` defined (CMake: `-DSTRING_INSTRUMENT=ON`). Otherwise the hooks compile to
+/// nothing, and every snapshot is all zeros.
+///
+/// Counters are kept per thread and aggregated when a snapshot is taken. An operation called from
+/// within another instrumented operation (for example the Strings constructed by String::split) is
+/// attributed to the outer operation, so each allocation is counted exactly once.
+///
+/// Example
+///
+///     StringStats::reset();
+///     run_request();
+///     std::cout << StringStats::snapshot().to_text();
+///
+class StringStats
+{
+private:
+    std::array<StringOperationStats, std::size_t(StringOperation::Count)> m_stats {};
+
+public:
+    /// \brief Whether the library was compiled with `STRING_INSTRUMENT`.
+    static constexpr bool enabled() noexcept {
+#if defined(STRING_INSTRUMENT)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /// \brief Sum of the counters of all threads, including threads which have exited.
+    static StringStats snapshot();
+    /// \brief Sets the counters of all threads to zero. Operations running on other threads meanwhile
+    /// count only with what they record after the reset.
+    static void reset();
+    /// \brief Lowercase name of the operation, as used in to_text and to_json.
+    static const char* name(StringOperation operation) noexcept;
+
+    /// \brief The counters of `operation`.
+    const StringOperationStats& operator[](StringOperation operation) const noexcept {
+        return m_stats[std::size_t(operation)];
+    }
+    /// \brief The counters of `operation`.
+    StringOperationStats& operator[](StringOperation operation) noexcept {
+        return m_stats[std::size_t(operation)];
+    }
+
+    /// \brief Human readable table, one line per operation.
+    String to_text() const;
+    /// \brief The counters as a JSON object, keyed by operation name.
+    String to_json() const;
+};
+
+namespace detail {
+
+/// \brief Records one call of an operation on destruction. Used through STRING_INSTRUMENT_SCOPE.
+class InstrumentScope
+{
+private:
+    StringOperation          m_operation;
+    const std::vector<char>* m_chars;
+    std::size_t              m_capacity_before;
+    std::uint64_t            m_start;
+    std::uint64_t            m_bytes_copied { 0 };
+    std::uint64_t            m_allocations { 0 };
+    std::uint64_t            m_reallocations { 0 };
+    InstrumentScope*         m_parent;
+
+public:
+    InstrumentScope(StringOperation operation, const std::vector<char>* chars) noexcept;
+    ~InstrumentScope();
+    InstrumentScope(const InstrumentScope&) = delete;
+    InstrumentScope& operator=(const InstrumentScope&) = delete;
+
+    /// \brief Adds to the counters of the innermost running operation of this thread.
+    static void add(std::uint64_t bytes_copied, std::uint64_t allocations) noexcept;
+};
+
+}
+
+#if defined(STRING_INSTRUMENT)
+#define STRING_INSTRUMENT_SCOPE(operation, chars) \
+    ::detail::InstrumentScope string_instrument_scope_((operation), (chars))
+#define STRING_INSTRUMENT_ADD(bytes_copied, allocations) \
+    ::detail::InstrumentScope::add((bytes_copied), (allocations))
+#else
+#define STRING_INSTRUMENT_SCOPE(operation, chars) static_cast<void>(0)
+#define STRING_INSTRUMENT_ADD(bytes_copied, allocations) static_cast<void>(0)
+#endif
+
+#endif // STRING_INSTRUMENT_H
@@ -0,0 +1,138 @@
+#ifndef STRINGLIST_H
+#define STRINGLIST_H
+
+#include "String.h"
+
+#include <initializer_list>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+/// \brief A list of strings, stored back to back in one contiguous buffer.
+///
+/// Where a `std::vector<String>` needs one allocation per element, a StringList needs two in total:
+/// one buffer for all chars, and one array of offsets into it. This makes it cheap to build, cheap
+/// to throw away, and fast to scan from front to back. Elements are accessed as
+/// `std::string_view`s into the buffer.
+///
+/// Reuse a StringList with String::split_into to split many inputs without any allocations once
+/// the capacity is large enough.
+///
+/// \attention Views returned by a StringList are invalidated by any operation that adds elements.
+class StringList
+{
+private:
+    std::vector<char>        m_chars;
+    // m_offsets[i] is where element i starts, m_offsets[i + 1] where it ends. Empty in a list that
+    // was moved from, which has no elements just like { 0 }.
+    std::vector<std::size_t> m_offsets { 0 };
+
+public:
+    /// \brief Random access iterator over the elements, as `std::string_view`s.
+    class ConstIterator
+    {
+    private:
+        const StringList* m_list { nullptr };
+        std::size_t       m_index { 0 };
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type        = std::string_view;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = void;
+        using reference         = std::string_view;
+
+        ConstIterator() = default;
+        ConstIterator(const StringList* list, std::size_t index)
+            : m_list(list)
+            , m_index(index) { }
+
+        std::string_view operator*() const { return (*m_list)[m_index]; }
+        std::string_view operator[](difference_type n) const { return (*m_list)[m_index + n]; }
+
+        ConstIterator& operator++() {
+            ++m_index;
+            return *this;
+        }
+        ConstIterator operator++(int) {
+            auto copy = *this;
+            ++m_index;
+            return copy;
+        }
+        ConstIterator& operator--() {
+            --m_index;
+            return *this;
+        }
+        ConstIterator operator--(int) {
+            auto copy = *this;
+            --m_index;
+            return copy;
+        }
+        ConstIterator& operator+=(difference_type n) {
+            m_index += n;
+            return *this;
+        }
+        ConstIterator& operator-=(difference_type n) {
+            m_index -= n;
+            return *this;
+        }
+        ConstIterator   operator+(difference_type n) const { return ConstIterator(m_list, m_index + n); }
+        ConstIterator   operator-(difference_type n) const { return ConstIterator(m_list, m_index - n); }
+        difference_type operator-(const ConstIterator& other) const { return difference_type(m_index) - difference_type(other.m_index); }
+
+        bool operator==(const ConstIterator& other) const { return m_index == other.m_index; }
+        bool operator!=(const ConstIterator& other) const { return m_index != other.m_index; }
+        bool operator<(const ConstIterator& other) const { return m_index < other.m_index; }
+        bool operator>(const ConstIterator& other) const { return m_index > other.m_index; }
+        bool operator<=(const ConstIterator& other) const { return m_index <= other.m_index; }
+        bool operator>=(const ConstIterator& other) const { return m_index >= other.m_index; }
+    };
+
+    /// \brief New empty list.
+    StringList() = default;
+    /// \brief New list with copies of all `elements`.
+    StringList(std::initializer_list<std::string_view> elements);
+    /// \brief New list with copies of all `elements`.
+    explicit StringList(const std::vector<String>& elements);
+
+    /// \brief Amount of elements in the list.
+    std::size_t size() const noexcept { return m_offsets.empty() ? 0 : m_offsets.size() - 1; }
+    /// \brief True if the list has no elements.
+    bool empty() const noexcept { return m_offsets.size() <= 1; }
+    /// \brief Sum of the sizes of all elements.
+    std::size_t total_size() const noexcept { return m_chars.size(); }
+
+    /// \brief The element at index `i`. No bounds checking is done.
+    std::string_view operator[](std::size_t i) const noexcept {
+        return std::string_view(m_chars.data() + m_offsets[i], m_offsets[i + 1] - m_offsets[i]);
+    }
+    /// \brief The element at index `i`.
+    /// \throw std::out_of_range if `i` is an invalid index
+    std::string_view at(std::size_t i) const;
+    /// \brief The first element. The list must not be empty.
+    std::string_view front() const noexcept { return (*this)[0]; }
+    /// \brief The last element. The list must not be empty.
+    std::string_view back() const noexcept { return (*this)[size() - 1]; }
+
+    ConstIterator begin() const noexcept { return ConstIterator(this, 0); }
+    ConstIterator end() const noexcept { return ConstIterator(this, size()); }
+
+    /// \brief Appends a copy of `element`. `element` may be a view into this list.
+    void push_back(std::string_view element);
+    /// \brief Removes the last element. The list must not be empty.
+    void pop_back() noexcept;
+    /// \brief Removes all elements. Keeps the capacity, so the list can be refilled without allocating.
+    void clear() noexcept;
+    /// \brief Grows the capacity to fit `elements` many elements with `total_size` chars in total.
+    void reserve(std::size_t elements, std::size_t total_size);
+
+    /// \brief Copies of all elements as separate Strings.
+    std::vector<String> to_vector() const;
+
+    /// \brief Whether both lists have the same elements in the same order.
+    bool operator==(const StringList& other) const noexcept;
+    /// \brief Whether the lists differ in any element.
+    bool operator!=(const StringList& other) const noexcept { return !(*this == other); }
+};
+
+#endif // STRINGLIST_H
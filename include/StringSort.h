@@ -0,0 +1,62 @@
+#ifndef STRINGSORT_H
+#define STRINGSORT_H
+
+#include "String.h"
+#include "StringList.h"
+
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace detail {
+
+/// \brief A string to be sorted, and where it came from.
+struct SortKey {
+    const char* data;
+    std::size_t size;
+    std::size_t index;
+};
+
+/// \brief Sorts `keys` by their chars, in the order of String::compare.
+void sort_keys(SortKey* keys, std::size_t n);
+
+}
+
+/// \brief Sorts `strings` in the order of String::compare, which is byte-wise like `std::memcmp`.
+///
+/// Sorts with an MSD radix sort, which looks at every char at most once instead of comparing common
+/// prefixes over and over like `std::sort` does. Each pass first copies the chars it distributes by
+/// into a contiguous array, so counting and distributing do not chase a pointer per string. Buckets
+/// of fewer than 64 strings are finished with a multikey quicksort.
+///
+/// `strings` may be any random access range of elements convertible to `std::string_view`, like a
+/// `std::vector<String>` or a `std::vector<std::string>`. The elements are moved into their places
+/// once all of them are sorted. The sort is not stable, but as equal elements have equal chars this
+/// is only observable through their addresses.
+template<class Range>
+void sort_strings(Range& strings) {
+    using Value = std::decay_t<decltype(*std::begin(strings))>;
+    const auto                   first = std::begin(strings);
+    const auto                   n     = std::size_t(std::distance(first, std::end(strings)));
+    std::vector<detail::SortKey> keys;
+    keys.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::string_view chars(first[i]);
+        keys.push_back(detail::SortKey { chars.data(), chars.size(), i });
+    }
+    detail::sort_keys(keys.data(), keys.size());
+    std::vector<Value> sorted;
+    sorted.reserve(n);
+    for (const auto& key : keys)
+        sorted.push_back(std::move(first[key.index]));
+    std::move(sorted.begin(), sorted.end(), first);
+}
+
+/// \brief Sorts the elements of `strings` in the order of String::compare. See sort_strings(Range&).
+///
+/// The chars of the list are copied into a new buffer once, in sorted order.
+void sort_strings(StringList& strings);
+
+#endif // STRINGSORT_H
@@ -0,0 +1,96 @@
+#ifndef SUBSTRINGINDEX_H
+#define SUBSTRINGINDEX_H
+
+#include "StringIO.h"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+/// \brief Suffix array index of an immutable text, for answering many substring queries without
+/// scanning the text for each.
+///
+/// The suffix array lists the offsets of all suffixes of the text in sorted order, so the
+/// occurrences of any pattern are one contiguous range of it, found by binary search in O(m log n)
+/// for a pattern of m chars. It is built in O(n) with SA-IS (Nong, Zhang and Chan), together with
+/// the LCP array (Kasai et al.): the length of the common prefix of each suffix and the one before
+/// it in sorted order.
+///
+/// The index takes 8 bytes per char of text and does not copy the text, which must outlive it and
+/// must not change. Texts of up to SubstringIndex::max_size chars can be indexed.
+///
+/// Building is the expensive part, so an index can be saved to a file with SubstringIndex::save and
+/// mapped back into memory with SubstringIndex::load, which is O(n) only for checking the text and
+/// that the arrays stay within it.
+///
+/// Example
+///
+///     const MappedFile corpus("corpus.txt");
+///     SubstringIndex   index(corpus.view());
+///     index.save("corpus.idx");
+///     ...
+///     const auto index = SubstringIndex::load("corpus.idx", corpus.view());
+///     for (auto offset : index.find_all("needle"))
+///         ...
+///
+class SubstringIndex
+{
+private:
+    std::string_view           m_text;
+    // the suffix array followed by the LCP array, when built here
+    std::vector<std::uint32_t> m_storage;
+    // the index file, when loaded
+    MappedFile                 m_file;
+    const std::uint32_t*       m_suffixes { nullptr };
+    const std::uint32_t*       m_lcp { nullptr };
+
+    std::size_t lower_bound(std::string_view pattern) const noexcept;
+    std::size_t upper_bound(std::string_view pattern) const noexcept;
+
+public:
+    /// \brief Largest text size that can be indexed.
+    static constexpr std::size_t max_size = 0x7fffffff;
+
+    /// \brief Index of an empty text.
+    SubstringIndex() = default;
+    /// \brief Builds the index of `text` in O(n) time. Does not copy `text`.
+    /// \throw std::length_error if `text` is longer than SubstringIndex::max_size.
+    explicit SubstringIndex(std::string_view text);
+    SubstringIndex(const SubstringIndex&) = delete;
+    SubstringIndex& operator=(const SubstringIndex&) = delete;
+    /// \brief Takes over the index of `other`, leaving it the index of an empty text.
+    SubstringIndex(SubstringIndex&& other) noexcept;
+    SubstringIndex& operator=(SubstringIndex&& other) noexcept;
+
+    /// \brief Writes the index to the file at `path`, replacing it. The text itself is not written,
+    /// only its size and a hash of it. The file uses the byte order of this machine.
+    /// \throw std::system_error if the file cannot be written.
+    void save(const char* path) const;
+    /// \brief Maps the index saved at `path` into memory, for the same `text` it was built for.
+    /// \throw std::system_error if the file cannot be opened or mapped.
+    /// \throw std::runtime_error if the file is not an index, is damaged, or was built for another text.
+    static SubstringIndex load(const char* path, std::string_view text);
+
+    /// \brief The indexed text.
+    std::string_view text() const noexcept { return m_text; }
+    /// \brief Amount of chars in the indexed text, which is also the amount of suffixes.
+    std::size_t size() const noexcept { return m_text.size(); }
+    /// \brief Offset of the suffix at `rank` in sorted order. No bounds checking is done.
+    std::size_t suffix(std::size_t rank) const noexcept { return m_suffixes[rank]; }
+    /// \brief Length of the common prefix of the suffixes at `rank` and `rank - 1` in sorted order,
+    /// 0 for rank 0. No bounds checking is done.
+    std::size_t lcp(std::size_t rank) const noexcept { return m_lcp[rank]; }
+
+    /// \brief Whether `pattern` occurs in the text. An empty pattern always does.
+    bool contains(std::string_view pattern) const noexcept;
+    /// \brief Amount of occurances of `pattern`, including overlapping ones. An empty pattern
+    /// occurs at each offset in [0, size()].
+    std::size_t count(std::string_view pattern) const noexcept;
+    /// \brief Offsets of all occurances of `pattern`, including overlapping ones, in ascending order.
+    std::vector<std::size_t> find_all(std::string_view pattern) const;
+    /// \brief The longest substring that occurs at least twice, the first in sorted order if there
+    /// are several. Empty if no char repeats.
+    std::string_view longest_repeat() const noexcept;
+};
+
+#endif // SUBSTRINGINDEX_H
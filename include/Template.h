@@ -0,0 +1,166 @@
+#ifndef TEMPLATE_H
+#define TEMPLATE_H
+
+#include "String.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// \brief A text template like `"Hello ${name}, your order ${id}"`, compiled once and rendered many
+/// times.
+///
+/// Supported syntax:
+///
+/// * `${name}` is a slot, replaced by the value of `name` when rendering. Names may contain any
+///   char except `}`, and may appear any number of times.
+/// * `$$` is a literal `$`. A `$` not followed by `{` or `$` is literal as well.
+///
+/// Rendering looks each distinct slot up exactly once, sums the sizes of all pieces, grows the
+/// output once and copies every piece once, instead of rescanning the text for every slot like
+/// repeated calls to String::replace do.
+///
+/// A lookup is either a callable taking the slot name as a `std::string_view` and returning the
+/// value as something convertible to `std::string_view` that outlives the call (a
+/// `std::string_view`, `const char*` or a reference), or a map-like container with `find` and
+/// `key_type`, like a `std::unordered_map<std::string_view, String>`. Maps whose keys are owning
+/// strings have to build a key per slot; prefer `std::string_view` keys.
+///
+/// Slot values may be escaped on the way in by passing an escaper: an object with
+///
+///     std::size_t size(std::string_view value) const; // size of the escaped value
+///     char* write(std::string_view value, char* out) const; // writes it, returns its end
+///
+/// Literal text is never escaped.
+///
+/// Example
+///
+///     Template greeting("Hello ${name}, your order ${id}");
+///     std::unordered_map<std::string_view, String> values { { "name", "Ada" }, { "id", "42" } };
+///     greeting.render(values); // -> "Hello Ada, your order 42"
+///
+class Template
+{
+public:
+    /// \brief The escaper used by default, which copies values unchanged.
+    struct NoEscape {
+        std::size_t size(std::string_view value) const noexcept { return value.size(); }
+        char* write(std::string_view value, char* out) const noexcept {
+            if (!value.empty())
+                std::memcpy(out, value.data(), value.size());
+            return out + value.size();
+        }
+    };
+
+private:
+    static constexpr std::size_t literal = std::size_t(-1);
+    // slots rendered without a heap allocation for the looked up values
+    static constexpr std::size_t inline_slots = 16;
+
+    struct Segment {
+        // index of the slot, or `literal` for the chars [offset, offset + size) of m_literals
+        std::size_t slot;
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    struct Name {
+        std::size_t offset;
+        std::size_t size;
+    };
+
+    String               m_source;
+    String               m_literals;
+    std::vector<Segment> m_segments;
+    // distinct slot names, as ranges of m_source, in order of first appearance
+    std::vector<Name>    m_slots;
+
+    void compile();
+
+    template<class Lookup>
+    static std::string_view value_of(const Lookup& lookup, std::string_view name) {
+        if constexpr (std::is_invocable_v<const Lookup&, std::string_view>) {
+            using Result = std::invoke_result_t<const Lookup&, std::string_view>;
+            static_assert(std::is_reference_v<Result> || std::is_same_v<std::decay_t<Result>, std::string_view>
+                    || std::is_same_v<std::decay_t<Result>, const char*>,
+                "the lookup must not return a temporary string, which would be gone before it is copied");
+            return std::string_view(lookup(name));
+        } else {
+            const auto found = lookup.find(typename Lookup::key_type(name));
+            if (found == lookup.end())
+                throw std::out_of_range("no value for template slot '" + std::string(name) + "'");
+            return std::string_view(found->second);
+        }
+    }
+
+    template<class CheckPolicy, class Escape>
+    void render_values(BasicString<CheckPolicy>& out, const std::string_view* values, const Escape& escape) const {
+        std::size_t total = 0;
+        for (const auto& segment : m_segments)
+            total += segment.slot == literal ? segment.size : escape.size(values[segment.slot]);
+        out.clear();
+        out.reserve(total);
+        char* write = out.append_uninitialized(total);
+        for (const auto& segment : m_segments) {
+            if (segment.slot == literal) {
+                std::memcpy(write, m_literals.data() + segment.offset, segment.size);
+                write += segment.size;
+            } else {
+                write = escape.write(values[segment.slot], write);
+            }
+        }
+    }
+
+public:
+    /// \brief Compiles `source`.
+    /// \throw std::invalid_argument if a `${` is not closed, or a slot has an empty name.
+    explicit Template(const String& source);
+    /// \brief Compiles `source`.
+    /// \throw std::invalid_argument if a `${` is not closed, or a slot has an empty name.
+    explicit Template(std::string_view source);
+    /// \brief Compiles `source`.
+    /// \throw std::invalid_argument if a `${` is not closed, or a slot has an empty name.
+    explicit Template(const char* source);
+
+    /// \brief The text this was compiled from.
+    const String& source() const noexcept { return m_source; }
+    /// \brief Amount of distinct slot names.
+    std::size_t slot_count() const noexcept { return m_slots.size(); }
+    /// \brief Name of the `index`-th distinct slot, in order of first appearance.
+    std::string_view slot_name(std::size_t index) const {
+        return m_source.view().substr(m_slots.at(index).offset, m_slots.at(index).size);
+    }
+
+    /// \brief Replaces the contents of `out` with the rendered template, reusing its buffer.
+    ///
+    /// `out` grows at most once, and not at all if its capacity suffices, so rendering into the
+    /// same String over and over does not allocate. Values must not point into `out`.
+    /// \throw std::out_of_range if `lookup` is a map without a value for a slot.
+    template<class CheckPolicy, class Lookup, class Escape = NoEscape>
+    void render_to(BasicString<CheckPolicy>& out, const Lookup& lookup, const Escape& escape = Escape()) const {
+        std::string_view              inline_values[inline_slots];
+        std::vector<std::string_view> heap_values;
+        std::string_view*             values = inline_values;
+        if (m_slots.size() > inline_slots) {
+            heap_values.resize(m_slots.size());
+            values = heap_values.data();
+        }
+        for (std::size_t i = 0; i < m_slots.size(); ++i)
+            values[i] = value_of(lookup, slot_name(i));
+        render_values(out, values, escape);
+    }
+
+    /// \brief Renders the template into a new String. See Template::render_to.
+    /// \throw std::out_of_range if `lookup` is a map without a value for a slot.
+    template<class Lookup, class Escape = NoEscape>
+    String render(const Lookup& lookup, const Escape& escape = Escape()) const {
+        String result;
+        render_to(result, lookup, escape);
+        return result;
+    }
+};
+
+#endif // TEMPLATE_H
@@ -0,0 +1,204 @@
+#include "Csv.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+CsvDialect CsvDialect::csv() {
+    return CsvDialect {};
+}
+
+CsvDialect CsvDialect::tsv() {
+    CsvDialect dialect;
+    dialect.delimiter = '\t';
+    dialect.quote     = '\0';
+    return dialect;
+}
+
+std::vector<String> CsvRecord::to_strings() const {
+    std::vector<String> result;
+    result.reserve(m_fields.size());
+    for (auto field : m_fields)
+        result.push_back(String(field));
+    return result;
+}
+
+CsvReader::CsvReader(const String& input, CsvDialect dialect)
+    : CsvReader(input.view(), dialect) {
+}
+
+CsvReader::CsvReader(std::string_view input, CsvDialect dialect)
+    : m_dialect(dialect)
+    , m_begin(input.data())
+    , m_end(input.data() + input.size()) {
+}
+
+CsvReader::CsvReader(std::istream& input, CsvDialect dialect, std::size_t chunk_size)
+    : m_dialect(dialect)
+    , m_stream(&input)
+    , m_eof(false)
+    , m_chunk_size(std::max<std::size_t>(chunk_size, 1)) {
+    m_buffer.reserve(m_chunk_size);
+}
+
+bool CsvReader::refill() {
+    if (m_eof)
+        return false;
+    // keep the unconsumed tail, it's the start of the record we're in the middle of
+    const auto kept = static_cast<std::size_t>(m_end - m_begin);
+    if (kept != 0 && m_begin != m_buffer.data())
+        std::memmove(m_buffer.data(), m_begin, kept);
+    // a record that does not fit is parsed again from its start after the refill, so reading at
+    // least as much as is kept doubles the buffer and keeps long records linear overall
+    const auto want = std::max(m_chunk_size, kept);
+    m_buffer.resize(kept + want);
+    m_stream->read(m_buffer.data() + kept, static_cast<std::streamsize>(want));
+    const auto got = static_cast<std::size_t>(m_stream->gcount());
+    m_buffer.resize(kept + got);
+    m_begin = m_buffer.data();
+    m_end   = m_buffer.data() + m_buffer.size();
+    if (got == 0)
+        m_eof = true;
+    return true;
+}
+
+bool CsvReader::next(CsvRecord& record) {
+    for (;;) {
+        if (m_dialect.skip_empty_lines)
+            while (m_begin != m_end && (*m_begin == '\n' || *m_begin == '\r'))
+                ++m_begin;
+        if (m_begin == m_end) {
+            if (!refill())
+                return false;
+            continue;
+        }
+        const char* pos = m_begin;
+        if (parse_record(pos, record) == Status::NeedMore) {
+            // only reported while the stream has more data, so this always succeeds
+            refill();
+            continue;
+        }
+        m_begin = pos;
+        record.m_fields.clear();
+        record.m_fields.reserve(record.m_spans.size());
+        for (const auto& span : record.m_spans) {
+            const char* data = span.in_scratch ? record.m_scratch.data() + span.offset : span.data;
+            record.m_fields.emplace_back(data, span.size);
+        }
+        ++m_records;
+        return true;
+    }
+}
+
+CsvReader::Status CsvReader::parse_record(const char*& pos, CsvRecord& record) const {
+    const auto& d   = m_dialect;
+    const char* p   = pos;
+    const char* end = m_end;
+    // disabled quote and escape chars ('\0') are searched for as duplicates of other chars instead
+    const char quoted_escape   = d.escape ? d.escape : d.quote;
+    const char unquoted_escape = d.escape ? d.escape : d.delimiter;
+    record.m_spans.clear();
+    record.m_scratch.clear();
+
+    const char* segment     = p;
+    bool        copied      = false;
+    std::size_t field_start = 0;
+    auto        begin_field = [&] {
+        copied      = false;
+        field_start = record.m_scratch.size();
+    };
+    auto end_field = [&](const char* to) {
+        CsvRecord::Span span { 0, 0, false, segment };
+        if (copied) {
+            record.m_scratch.insert(record.m_scratch.end(), segment, to);
+            span.offset     = field_start;
+            span.size       = record.m_scratch.size() - field_start;
+            span.in_scratch = true;
+        } else {
+            span.size = static_cast<std::size_t>(to - segment);
+        }
+        record.m_spans.push_back(span);
+    };
+    // copies everything up to the escape sequence at `q` into scratch, followed by `c`
+    auto unescape = [&](const char* q, char c) {
+        record.m_scratch.insert(record.m_scratch.end(), segment, q);
+        record.m_scratch.push_back(c);
+        copied = true;
+    };
+
+    for (;;) {
+        begin_field();
+        if (d.quote && p != end && *p == d.quote) {
+            // quoted field: everything up to the closing quote is content
+            p = segment = p + 1;
+            for (;;) {
+                const char* q = detail::find_any(p, end, d.quote, quoted_escape, d.quote, d.quote);
+                if (q == end || (q + 1 == end && (*q == d.escape || d.double_quote))) {
+                    if (!m_eof)
+                        return Status::NeedMore;
+                    if (q == end)
+                        throw std::runtime_error("unterminated quoted field");
+                }
+                if (*q == d.escape && d.escape) {
+                    if (q + 1 == end)
+                        throw std::runtime_error("dangling escape char at end of input");
+                    unescape(q, q[1]);
+                    p = segment = q + 2;
+                } else if (d.double_quote && q + 1 != end && q[1] == d.quote) {
+                    unescape(q, d.quote);
+                    p = segment = q + 2;
+                } else {
+                    end_field(q);
+                    p = q + 1;
+                    break;
+                }
+            }
+            if (p != end && *p != d.delimiter && *p != '\n' && *p != '\r')
+                throw std::runtime_error("unexpected char after closing quote");
+        } else {
+            // unquoted field: ends at the delimiter or newline
+            segment = p;
+            for (;;) {
+                const char* q = detail::find_any(p, end, d.delimiter, '\n', '\r', unquoted_escape);
+                if (q != end && *q == d.escape && d.escape) {
+                    if (q + 1 == end) {
+                        if (!m_eof)
+                            return Status::NeedMore;
+                        throw std::runtime_error("dangling escape char at end of input");
+                    }
+                    unescape(q, q[1]);
+                    p = segment = q + 2;
+                    continue;
+                }
+                end_field(q);
+                p = q;
+                break;
+            }
+        }
+
+        if (p == end) {
+            if (!m_eof)
+                return Status::NeedMore;
+            pos = p;
+            return Status::Complete;
+        }
+        if (*p == d.delimiter) {
+            ++p;
+            if (p == end && !m_eof)
+                return Status::NeedMore;
+            continue;
+        }
+        if (*p == '\r') {
+            if (p + 1 == end && !m_eof)
+                return Status::NeedMore;
+            ++p;
+            if (p != end && *p == '\n')
+                ++p;
+            pos = p;
+            return Status::Complete;
+        }
+        // '\n'
+        pos = p + 1;
+        return Status::Complete;
+    }
+}
@@ -0,0 +1,181 @@
+// Bit-parallel edit distance and approximate search.
+//
+// Both follow Myers, "A fast bit-vector algorithm for approximate string matching based on dynamic
+// programming" (1999), in the formulation by Hyyrö (2003) that splits long patterns into blocks of
+// 64 rows. Each column of the DP matrix is encoded as vertical deltas, one bit per row in `pv`
+// (+1) and `mv` (-1), so a whole column is advanced by one text char in a few word operations.
+
+#include "String.h"
+#include "StringList.h"
+
+namespace {
+
+// for each byte value, a bitmask of the pattern positions holding it
+struct PatternMasks {
+    std::size_t                size;
+    std::size_t                words;
+    std::vector<std::uint64_t> masks;
+
+    explicit PatternMasks(std::string_view pattern)
+        : size(pattern.size())
+        , words((pattern.size() + 63) / 64)
+        , masks(256 * words, 0) {
+        for (std::size_t i = 0; i < pattern.size(); ++i)
+            masks[static_cast<unsigned char>(pattern[i]) * words + i / 64] |= std::uint64_t(1) << (i % 64);
+    }
+
+    const std::uint64_t* of(char c) const { return &masks[static_cast<unsigned char>(c) * words]; }
+};
+
+// advances one block of 64 rows by one column, given the horizontal delta entering it from above,
+// and returns the delta leaving it at row `high`
+inline int advance_block(std::uint64_t& pv, std::uint64_t& mv, std::uint64_t eq, int h_in, std::uint64_t high) {
+    const std::uint64_t xv = eq | mv;
+    if (h_in < 0)
+        eq |= 1;
+    const std::uint64_t xh    = (((eq & pv) + pv) ^ pv) | eq;
+    std::uint64_t       ph    = mv | ~(xh | pv);
+    std::uint64_t       mh    = pv & xh;
+    const int           h_out = (ph & high) ? 1 : (mh & high) ? -1 : 0;
+    ph <<= 1;
+    mh <<= 1;
+    if (h_in < 0)
+        mh |= 1;
+    else if (h_in > 0)
+        ph |= 1;
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return h_out;
+}
+
+// Runs the pattern over `text` and calls `visit(j, score)` after each char, where `score` is the
+// last row of column j + 1 of the DP matrix. Stops early if `visit` returns false.
+//
+// With `Search`, the first row is all zeros, so a match may start anywhere in the text, otherwise
+// it counts up from 0 and the whole text is compared.
+template<bool Search, class Visit>
+void scan(const PatternMasks& pattern, std::string_view text, Visit visit) {
+    const std::size_t   last_bits = pattern.size - (pattern.words - 1) * 64;
+    const std::uint64_t last_high = std::uint64_t(1) << (last_bits - 1);
+    const int           top       = Search ? 0 : 1;
+    std::size_t         score     = pattern.size;
+    auto                add       = [&score](int delta) {
+        if (delta > 0)
+            ++score;
+        else if (delta < 0)
+            --score;
+    };
+
+    if (pattern.words == 1) {
+        std::uint64_t pv = ~std::uint64_t(0);
+        std::uint64_t mv = 0;
+        for (std::size_t j = 0; j < text.size(); ++j) {
+            add(advance_block(pv, mv, *pattern.of(text[j]), top, last_high));
+            if (!visit(j, score))
+                return;
+        }
+        return;
+    }
+
+    std::vector<std::uint64_t> pv(pattern.words, ~std::uint64_t(0));
+    std::vector<std::uint64_t> mv(pattern.words, 0);
+    const std::uint64_t        high = std::uint64_t(1) << 63;
+    for (std::size_t j = 0; j < text.size(); ++j) {
+        const std::uint64_t* eq = pattern.of(text[j]);
+        int                  h  = top;
+        for (std::size_t w = 0; w + 1 < pattern.words; ++w)
+            h = advance_block(pv[w], mv[w], eq[w], h, high);
+        h = advance_block(pv.back(), mv.back(), eq[pattern.words - 1], h, last_high);
+        add(h);
+        if (!visit(j, score))
+            return;
+    }
+}
+
+std::size_t bounded(std::size_t distance, std::size_t max) {
+    return distance <= max ? distance : max + 1;
+}
+
+std::size_t distance_between(const PatternMasks& pattern, std::string_view text, std::size_t max) {
+    const std::size_t m = pattern.size;
+    const std::size_t n = text.size();
+    if (m == 0 || n == 0)
+        return bounded(m + n, max);
+    if ((m > n ? m - n : n - m) > max)
+        return max + 1;
+    std::size_t result = 0;
+    bool        gave_up = false;
+    scan<false>(pattern, text, [&](std::size_t j, std::size_t score) {
+        // each remaining char lowers the last row by at most one
+        const std::size_t remaining = n - j - 1;
+        if (score > remaining && score - remaining > max) {
+            gave_up = true;
+            return false;
+        }
+        result = score;
+        return true;
+    });
+    return gave_up ? max + 1 : bounded(result, max);
+}
+
+template<class Candidates>
+std::vector<std::size_t> distances_to(std::string_view query, const Candidates& candidates, std::size_t max) {
+    const PatternMasks       pattern(query);
+    std::vector<std::size_t> result;
+    result.reserve(candidates.size());
+    for (const auto& candidate : candidates)
+        result.push_back(distance_between(pattern, std::string_view(candidate), max));
+    return result;
+}
+
+}
+
+template<class CheckPolicy>
+std::size_t BasicString<CheckPolicy>::edit_distance(std::string_view other, std::size_t max) const {
+    // the shorter string as the pattern needs fewer blocks
+    const auto self = view();
+    if (other.size() < self.size())
+        return distance_between(PatternMasks(other), self, max);
+    return distance_between(PatternMasks(self), other, max);
+}
+
+template<class CheckPolicy>
+std::vector<std::size_t> BasicString<CheckPolicy>::edit_distances(std::string_view query, const std::vector<BasicString>& candidates, std::size_t max) {
+    return distances_to(query, candidates, max);
+}
+
+template<class CheckPolicy>
+std::vector<std::size_t> BasicString<CheckPolicy>::edit_distances(std::string_view query, const StringList& candidates, std::size_t max) {
+    return distances_to(query, candidates, max);
+}
+
+template<class CheckPolicy>
+std::vector<StringBase::FuzzyMatch> BasicString<CheckPolicy>::fuzzy_find(std::string_view pattern, std::size_t k) const {
+    std::vector<FuzzyMatch> result;
+    if (pattern.empty()) {
+        for (std::size_t end = 0; end <= size(); ++end)
+            result.push_back(FuzzyMatch { end, 0 });
+        return result;
+    }
+    // the empty substring at the very start, reached by deleting the whole pattern
+    if (pattern.size() <= k)
+        result.push_back(FuzzyMatch { 0, pattern.size() });
+    scan<true>(PatternMasks(pattern), view(), [&](std::size_t j, std::size_t score) {
+        if (score <= k)
+            result.push_back(FuzzyMatch { j + 1, score });
+        return true;
+    });
+    return result;
+}
+
+// the rest of BasicString is instantiated in String.cpp
+#define STRING_INSTANTIATE_EDIT_DISTANCE(Policy)                                                                           \
+    template std::size_t BasicString<Policy>::edit_distance(std::string_view, std::size_t) const;                         \
+    template std::vector<std::size_t> BasicString<Policy>::edit_distances(std::string_view, const std::vector<BasicString>&, \
+        std::size_t);                                                                                                      \
+    template std::vector<std::size_t> BasicString<Policy>::edit_distances(std::string_view, const StringList&, std::size_t); \
+    template std::vector<StringBase::FuzzyMatch> BasicString<Policy>::fuzzy_find(std::string_view, std::size_t) const;
+
+STRING_INSTANTIATE_EDIT_DISTANCE(Checked)
+STRING_INSTANTIATE_EDIT_DISTANCE(Unchecked)
+#undef STRING_INSTANTIATE_EDIT_DISTANCE
@@ -0,0 +1,430 @@
+// Hex and Base64 encoding and decoding of String.
+
+#include "String.h"
+#include "Simd.h"
+
+#include <cstring>
+#include <stdexcept>
+
+// The Base64 kernels need SSSE3, which is not part of baseline x86-64. They are compiled for it
+// whatever the target, and only run where the CPU has it.
+#if defined(STRING_SIMD_SSE2) && defined(__GNUC__)
+#define STRING_BASE64_SSSE3 1
+#define STRING_TARGET_SSSE3 __attribute__((target("ssse3")))
+#include <tmmintrin.h>
+#endif
+
+namespace {
+
+constexpr char hex_digits[] = "0123456789abcdef";
+
+constexpr char base64_standard[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr char base64_url[]      = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// value of each hex digit, 0xff for anything else
+struct HexTable {
+    std::uint8_t values[256];
+    constexpr HexTable()
+        : values() {
+        for (int i = 0; i < 256; ++i)
+            values[i] = 0xff;
+        for (int i = 0; i < 10; ++i)
+            values['0' + i] = std::uint8_t(i);
+        for (int i = 0; i < 6; ++i) {
+            values['a' + i] = std::uint8_t(10 + i);
+            values['A' + i] = std::uint8_t(10 + i);
+        }
+    }
+};
+
+constexpr HexTable hex_table;
+
+// value of each char in a base64 alphabet, 0xff for anything else
+struct Base64Table {
+    std::uint8_t values[256];
+    constexpr Base64Table(const char* alphabet)
+        : values() {
+        for (int i = 0; i < 256; ++i)
+            values[i] = 0xff;
+        for (int i = 0; i < 64; ++i)
+            values[static_cast<unsigned char>(alphabet[i])] = std::uint8_t(i);
+    }
+};
+
+constexpr Base64Table base64_standard_table(base64_standard);
+constexpr Base64Table base64_url_table(base64_url);
+
+const char* alphabet_of(String::Base64Alphabet alphabet) {
+    return alphabet == String::Base64Alphabet::Url ? base64_url : base64_standard;
+}
+
+const Base64Table& table_of(String::Base64Alphabet alphabet) {
+    return alphabet == String::Base64Alphabet::Url ? base64_url_table : base64_standard_table;
+}
+
+[[noreturn]] void throw_invalid(const char* what, std::size_t position) {
+    throw std::invalid_argument(std::string(what) + " at position " + std::to_string(position));
+}
+
+void encode_hex(const char* in, std::size_t n, char* out) {
+    std::size_t i = 0;
+#if defined(STRING_SIMD_SSE2)
+    const __m128i low_nibble = _mm_set1_epi8(0x0f);
+    const __m128i nine       = _mm_set1_epi8(9);
+    const __m128i digit_base = _mm_set1_epi8('0');
+    const __m128i letter_gap = _mm_set1_epi8('a' - '0' - 10);
+    auto          to_ascii   = [&](__m128i nibbles) {
+        const __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(nibbles, nine), letter_gap);
+        return _mm_add_epi8(_mm_add_epi8(nibbles, digit_base), letters);
+    };
+    for (; i + detail::simd_width <= n; i += detail::simd_width) {
+        const __m128i v  = detail::load16(in + i);
+        const __m128i hi = to_ascii(_mm_and_si128(_mm_srli_epi16(v, 4), low_nibble));
+        const __m128i lo = to_ascii(_mm_and_si128(v, low_nibble));
+        detail::store16(out + 2 * i, _mm_unpacklo_epi8(hi, lo));
+        detail::store16(out + 2 * i + detail::simd_width, _mm_unpackhi_epi8(hi, lo));
+    }
+#endif
+    for (; i < n; ++i) {
+        const auto c   = static_cast<unsigned char>(in[i]);
+        out[2 * i]     = hex_digits[c >> 4];
+        out[2 * i + 1] = hex_digits[c & 0x0f];
+    }
+}
+
+// returns the position of the first invalid char, or `n` if all were valid
+std::size_t decode_hex(const char* in, std::size_t n, char* out) {
+    std::size_t i = 0;
+#if defined(STRING_SIMD_SSE2)
+    const __m128i lower_bit = _mm_set1_epi8(0x20);
+    const __m128i digit_0   = _mm_set1_epi8('0');
+    const __m128i letter_a  = _mm_set1_epi8('a' - 10);
+    const __m128i low_byte  = _mm_set1_epi16(0x00ff);
+    auto          values_of = [&](__m128i v, std::uint32_t& invalid) {
+        const __m128i digit  = detail::in_range(v, '0', '9');
+        const __m128i folded = _mm_or_si128(v, lower_bit);
+        const __m128i letter = detail::in_range(folded, 'a', 'f');
+        invalid |= ~detail::movemask(_mm_or_si128(digit, letter)) & 0xffff;
+        return _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(v, digit_0)),
+                            _mm_and_si128(letter, _mm_sub_epi8(folded, letter_a)));
+    };
+    // two chars per output byte, the first one (low byte of each 16 bit lane) is the high nibble
+    auto combine = [&](__m128i values) {
+        return _mm_or_si128(_mm_slli_epi16(_mm_and_si128(values, low_byte), 4), _mm_srli_epi16(values, 8));
+    };
+    for (; i + 2 * detail::simd_width <= n; i += 2 * detail::simd_width) {
+        std::uint32_t invalid = 0;
+        const __m128i first   = values_of(detail::load16(in + i), invalid);
+        const __m128i second  = values_of(detail::load16(in + i + detail::simd_width), invalid);
+        if (invalid)
+            break; // the scalar loop finds the exact position
+        detail::store16(out + i / 2, _mm_packus_epi16(combine(first), combine(second)));
+    }
+#endif
+    for (; i < n; i += 2) {
+        const auto hi = hex_table.values[static_cast<unsigned char>(in[i])];
+        const auto lo = hex_table.values[static_cast<unsigned char>(in[i + 1])];
+        if (hi == 0xff)
+            return i;
+        if (lo == 0xff)
+            return i + 1;
+        out[i / 2] = static_cast<char>((hi << 4) | lo);
+    }
+    return n;
+}
+
+std::size_t base64_encoded_size(std::size_t n, bool padding) {
+    if (padding)
+        return (n + 2) / 3 * 4;
+    return n / 3 * 4 + (n % 3 == 0 ? 0 : n % 3 + 1);
+}
+
+#if defined(STRING_BASE64_SSSE3)
+bool has_ssse3() {
+#if defined(__SSSE3__)
+    return true;
+#else
+    static const bool supported = __builtin_cpu_supports("ssse3");
+    return supported;
+#endif
+}
+
+// 12 input bytes (16 readable) -> 16 base64 chars, after Wojciech Muła's SSSE3 encoder
+STRING_TARGET_SSSE3 __m128i encode_base64_block(const char* in, __m128i shift_lut) {
+    __m128i v = _mm_shuffle_epi8(detail::load16(in), _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    // split each 3 bytes into four 6 bit indices, one per output byte
+    const __m128i t0      = _mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00));
+    const __m128i t1      = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    const __m128i t2      = _mm_and_si128(v, _mm_set1_epi32(0x003f03f0));
+    const __m128i t3      = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(t1, t3);
+    // map the indices to ascii, by adding an offset depending on the range they fall into
+    __m128i       ranges = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    const __m128i less   = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    ranges               = _mm_or_si128(ranges, _mm_and_si128(less, _mm_set1_epi8(13)));
+    return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, ranges), indices);
+}
+
+// encodes blocks of 12 bytes while 16 are readable, returns the amount of bytes encoded
+STRING_TARGET_SSSE3 std::size_t encode_base64_ssse3(const char* in, std::size_t n, char* out, const char* chars) {
+    const __m128i shift_lut = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        chars[62] - 62, chars[63] - 63, 'A', 0, 0);
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 12, out += 16)
+        detail::store16(out, encode_base64_block(in + i, shift_lut));
+    return i;
+}
+
+// decodes blocks of 16 chars into 12 bytes, the packing after Wojciech Muła's SSSE3 decoder. Chars
+// are mapped by range rather than by lookup, which works for both alphabets. Stops before the first
+// block with an invalid char, returns the amount of chars decoded.
+STRING_TARGET_SSSE3 std::size_t decode_base64_ssse3(const char* in, std::size_t n, char* out, const char* chars) {
+    const __m128i char_62 = _mm_set1_epi8(chars[62]);
+    const __m128i char_63 = _mm_set1_epi8(chars[63]);
+    std::size_t   i       = 0;
+    for (; i + 16 <= n; i += 16, out += 12) {
+        const __m128i v     = detail::load16(in + i);
+        const __m128i upper = detail::in_range(v, 'A', 'Z');
+        const __m128i lower = detail::in_range(v, 'a', 'z');
+        const __m128i digit = detail::in_range(v, '0', '9');
+        const __m128i is_62 = _mm_cmpeq_epi8(v, char_62);
+        const __m128i is_63 = _mm_cmpeq_epi8(v, char_63);
+        const __m128i valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, is_62)), is_63);
+        if (detail::movemask(valid) != 0xffff)
+            break; // the scalar loop finds the exact position
+        const __m128i offsets = _mm_or_si128(
+            _mm_or_si128(_mm_and_si128(upper, _mm_set1_epi8(-'A')), _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+            _mm_or_si128(_mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+                         _mm_or_si128(_mm_and_si128(is_62, _mm_set1_epi8(static_cast<char>(62 - chars[62]))),
+                                      _mm_and_si128(is_63, _mm_set1_epi8(static_cast<char>(63 - chars[63]))))));
+        const __m128i values = _mm_add_epi8(v, offsets);
+        // merge the four 6 bit values of each 32 bit lane into 24 bits, then drop the top bytes
+        const __m128i pairs  = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        const __m128i merged = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        const __m128i bytes  = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(out), bytes);
+        const auto tail = static_cast<std::uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(bytes, 8)));
+        std::memcpy(out + 8, &tail, 4);
+    }
+    return i;
+}
+#endif
+
+void encode_base64(const char* in, std::size_t n, char* out, String::Base64Alphabet alphabet, bool padding) {
+    const char* chars = alphabet_of(alphabet);
+    std::size_t i     = 0;
+#if defined(STRING_BASE64_SSSE3)
+    if (has_ssse3()) {
+        i = encode_base64_ssse3(in, n, out, chars);
+        out += i / 3 * 4;
+    }
+#endif
+    for (; i + 3 <= n; i += 3, out += 4) {
+        const auto a = static_cast<unsigned char>(in[i]);
+        const auto b = static_cast<unsigned char>(in[i + 1]);
+        const auto c = static_cast<unsigned char>(in[i + 2]);
+        out[0]       = chars[a >> 2];
+        out[1]       = chars[((a & 0x03) << 4) | (b >> 4)];
+        out[2]       = chars[((b & 0x0f) << 2) | (c >> 6)];
+        out[3]       = chars[c & 0x3f];
+    }
+    const auto rest = n - i;
+    if (rest == 0)
+        return;
+    const auto a = static_cast<unsigned char>(in[i]);
+    const auto b = rest == 2 ? static_cast<unsigned char>(in[i + 1]) : 0;
+    out[0]       = chars[a >> 2];
+    out[1]       = chars[((a & 0x03) << 4) | (b >> 4)];
+    if (rest == 2)
+        out[2] = chars[(b & 0x0f) << 2];
+    else if (padding)
+        out[2] = '=';
+    if (padding)
+        out[3] = '=';
+}
+
+// size of the decoded data, or throws if the length or padding is invalid
+std::size_t base64_decoded_size(std::string_view in) {
+    std::size_t n = in.size();
+    if (n % 4 == 0 && n != 0) {
+        if (in[n - 1] == '=')
+            --n;
+        if (in[n - 1] == '=')
+            --n;
+    }
+    if (n % 4 == 1)
+        throw_invalid("invalid base64 length", in.size());
+    return n / 4 * 3 + (n % 4 == 0 ? 0 : n % 4 - 1);
+}
+
+// decodes `n` chars without padding, returns the position of the first invalid char, or `n`
+std::size_t decode_base64(const char* in, std::size_t n, char* out, String::Base64Alphabet alphabet) {
+    const auto& table = table_of(alphabet);
+    std::size_t i     = 0;
+#if defined(STRING_BASE64_SSSE3)
+    if (has_ssse3()) {
+        i = decode_base64_ssse3(in, n, out, alphabet_of(alphabet));
+        out += i / 4 * 3;
+    }
+#endif
+    for (; i + 4 <= n; i += 4, out += 3) {
+        const std::uint32_t a = table.values[static_cast<unsigned char>(in[i])];
+        const std::uint32_t b = table.values[static_cast<unsigned char>(in[i + 1])];
+        const std::uint32_t c = table.values[static_cast<unsigned char>(in[i + 2])];
+        const std::uint32_t d = table.values[static_cast<unsigned char>(in[i + 3])];
+        if ((a | b | c | d) & 0x80)
+            break;
+        const std::uint32_t bits = (a << 18) | (b << 12) | (c << 6) | d;
+        out[0]                   = static_cast<char>(bits >> 16);
+        out[1]                   = static_cast<char>(bits >> 8);
+        out[2]                   = static_cast<char>(bits);
+    }
+    if (i + 4 <= n) {
+        // the loop above stopped on an invalid char
+        for (;; ++i)
+            if (table.values[static_cast<unsigned char>(in[i])] & 0x80)
+                return i;
+    }
+    const auto rest = n - i;
+    for (std::size_t j = 0; j < rest; ++j)
+        if (table.values[static_cast<unsigned char>(in[i + j])] & 0x80)
+            return i + j;
+    if (rest >= 2) {
+        const std::uint32_t a = table.values[static_cast<unsigned char>(in[i])];
+        const std::uint32_t b = table.values[static_cast<unsigned char>(in[i + 1])];
+        out[0]                = static_cast<char>((a << 2) | (b >> 4));
+        if (rest == 3) {
+            const std::uint32_t c = table.values[static_cast<unsigned char>(in[i + 2])];
+            out[1]                = static_cast<char>(((b & 0x0f) << 4) | (c >> 2));
+        }
+    }
+    return n;
+}
+
+}
+
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::to_hex() const {
+    BasicString result;
+    to_hex(result);
+    return result;
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::to_hex(BasicString& out) const {
+    // `out` may be this string, so reserve before taking the input pointer
+    const auto n = size();
+    out.reserve(out.size() + 2 * n);
+    const char* in = data();
+    encode_hex(in, n, out.append_uninitialized(2 * n));
+}
+
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::from_hex(std::string_view hex) {
+    BasicString result;
+    from_hex(hex, result);
+    return result;
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::from_hex(std::string_view hex, BasicString& out) {
+    if (hex.size() % 2 != 0)
+        throw_invalid("odd length hex string", hex.size());
+    if (out.overlaps(hex)) {
+        from_hex(BasicString(hex), out);
+        return;
+    }
+    const auto old_size = out.size();
+    const auto invalid  = decode_hex(hex.data(), hex.size(), out.append_uninitialized(hex.size() / 2));
+    if (invalid != hex.size()) {
+        out.set_size(old_size);
+        throw_invalid("invalid hex digit", invalid);
+    }
+}
+
+template<class CheckPolicy>
+bool BasicString<CheckPolicy>::is_hex(std::string_view hex) noexcept {
+    if (hex.size() % 2 != 0)
+        return false;
+    for (char c : hex)
+        if (hex_table.values[static_cast<unsigned char>(c)] == 0xff)
+            return false;
+    return true;
+}
+
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::to_base64(Base64Alphabet alphabet, bool padding) const {
+    BasicString result;
+    to_base64(result, alphabet, padding);
+    return result;
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::to_base64(BasicString& out, Base64Alphabet alphabet, bool padding) const {
+    // `out` may be this string, so reserve before taking the input pointer
+    const auto n            = size();
+    const auto encoded_size = base64_encoded_size(n, padding);
+    out.reserve(out.size() + encoded_size);
+    const char* in = data();
+    encode_base64(in, n, out.append_uninitialized(encoded_size), alphabet, padding);
+}
+
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::from_base64(std::string_view base64, Base64Alphabet alphabet) {
+    BasicString result;
+    from_base64(base64, result, alphabet);
+    return result;
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::from_base64(std::string_view base64, BasicString& out, Base64Alphabet alphabet) {
+    if (out.overlaps(base64)) {
+        from_base64(BasicString(base64), out, alphabet);
+        return;
+    }
+    const auto decoded_size = base64_decoded_size(base64);
+    // chars without the padding
+    const auto chars    = decoded_size / 3 * 4 + (decoded_size % 3 == 0 ? 0 : decoded_size % 3 + 1);
+    const auto old_size = out.size();
+    const auto invalid      = decode_base64(base64.data(), chars, out.append_uninitialized(decoded_size), alphabet);
+    if (invalid != chars) {
+        out.set_size(old_size);
+        throw_invalid("invalid base64 char", invalid);
+    }
+}
+
+template<class CheckPolicy>
+bool BasicString<CheckPolicy>::is_base64(std::string_view base64, Base64Alphabet alphabet) noexcept {
+    std::size_t n = base64.size();
+    if (n % 4 == 0 && n != 0) {
+        if (base64[n - 1] == '=')
+            --n;
+        if (base64[n - 1] == '=')
+            --n;
+    }
+    if (n % 4 == 1)
+        return false;
+    const auto& table = table_of(alphabet);
+    for (std::size_t i = 0; i < n; ++i)
+        if (table.values[static_cast<unsigned char>(base64[i])] & 0x80)
+            return false;
+    return true;
+}
+
+// the rest of BasicString is instantiated in String.cpp
+#define STRING_INSTANTIATE_ENCODING(Policy)                                                                      \
+    template BasicString<Policy> BasicString<Policy>::to_hex() const;                                            \
+    template void                BasicString<Policy>::to_hex(BasicString&) const;                                \
+    template BasicString<Policy> BasicString<Policy>::from_hex(std::string_view);                                \
+    template void                BasicString<Policy>::from_hex(std::string_view, BasicString&);                  \
+    template bool                BasicString<Policy>::is_hex(std::string_view) noexcept;                         \
+    template BasicString<Policy> BasicString<Policy>::to_base64(Base64Alphabet, bool) const;                     \
+    template void                BasicString<Policy>::to_base64(BasicString&, Base64Alphabet, bool) const;       \
+    template BasicString<Policy> BasicString<Policy>::from_base64(std::string_view, Base64Alphabet);             \
+    template void                BasicString<Policy>::from_base64(std::string_view, BasicString&, Base64Alphabet); \
+    template bool                BasicString<Policy>::is_base64(std::string_view, Base64Alphabet) noexcept;
+
+STRING_INSTANTIATE_ENCODING(Checked)
+STRING_INSTANTIATE_ENCODING(Unchecked)
+#undef STRING_INSTANTIATE_ENCODING
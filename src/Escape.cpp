@@ -0,0 +1,468 @@
+// JSON, HTML and URL escaping and unescaping of String.
+//
+// Most text needs no escaping at all, so every escape function first scans for the first char that
+// does, 16 chars at a time. From there the escaped size is counted in one pass over the input and
+// the output filled in a second, both skipping from one special char to the next with the same scan.
+
+#include "String.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr char lower_hex_digits[] = "0123456789abcdef";
+constexpr char upper_hex_digits[] = "0123456789ABCDEF";
+
+[[noreturn]] void throw_invalid(const char* what, std::size_t position) {
+    throw std::invalid_argument(std::string(what) + " at position " + std::to_string(position));
+}
+
+// value of a hex digit, or -1
+int hex_value(char c) {
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+char* write_utf8(std::uint32_t code, char* out) {
+    if (code < 0x80) {
+        *out++ = char(code);
+    } else if (code < 0x800) {
+        *out++ = char(0xc0 | code >> 6);
+        *out++ = char(0x80 | (code & 0x3f));
+    } else if (code < 0x10000) {
+        *out++ = char(0xe0 | code >> 12);
+        *out++ = char(0x80 | (code >> 6 & 0x3f));
+        *out++ = char(0x80 | (code & 0x3f));
+    } else {
+        *out++ = char(0xf0 | code >> 18);
+        *out++ = char(0x80 | (code >> 12 & 0x3f));
+        *out++ = char(0x80 | (code >> 6 & 0x3f));
+        *out++ = char(0x80 | (code & 0x3f));
+    }
+    return out;
+}
+
+// An escaper finds the chars it escapes, and knows how long they get and how to write them.
+
+struct JsonEscaper {
+    static const char* find(const char* p, const char* end) {
+        return detail::find_first_of_class(p, end, detail::json_escape_mask, detail::needs_json_escape);
+    }
+    static char short_form(char c) {
+        switch (c) {
+        case '"': return '"';
+        case '\\': return '\\';
+        case '\b': return 'b';
+        case '\f': return 'f';
+        case '\n': return 'n';
+        case '\r': return 'r';
+        case '\t': return 't';
+        default: return '\0';
+        }
+    }
+    static std::size_t size(char c) { return short_form(c) ? 2 : 6; }
+    static char* write(char c, char* out) {
+        *out++ = '\\';
+        if (const char s = short_form(c)) {
+            *out++ = s;
+            return out;
+        }
+        const auto u = static_cast<unsigned char>(c);
+        *out++ = 'u';
+        *out++ = '0';
+        *out++ = '0';
+        *out++ = lower_hex_digits[u >> 4];
+        *out++ = lower_hex_digits[u & 0xf];
+        return out;
+    }
+};
+
+struct HtmlEscaper {
+    static const char* find(const char* p, const char* end) {
+        return detail::find_first_of_class(p, end, detail::html_escape_mask, detail::needs_html_escape);
+    }
+    static std::string_view entity(char c) {
+        switch (c) {
+        case '&': return "&amp;";
+        case '<': return "&lt;";
+        case '>': return "&gt;";
+        case '"': return "&quot;";
+        default: return "&#39;";
+        }
+    }
+    static std::size_t size(char c) { return entity(c).size(); }
+    static char* write(char c, char* out) {
+        const auto e = entity(c);
+        std::memcpy(out, e.data(), e.size());
+        return out + e.size();
+    }
+};
+
+struct UrlEscaper {
+    static const char* find(const char* p, const char* end) {
+        return detail::find_first_of_class(p, end, detail::url_escape_mask, detail::needs_url_escape);
+    }
+    static std::size_t size(char) { return 3; }
+    static char* write(char c, char* out) {
+        const auto u = static_cast<unsigned char>(c);
+        *out++ = '%';
+        *out++ = upper_hex_digits[u >> 4];
+        *out++ = upper_hex_digits[u & 0xf];
+        return out;
+    }
+};
+
+// index of the first char in `chars` that `Escaper` escapes, or chars.size()
+template<class Escaper>
+std::size_t first_to_escape(std::string_view chars) {
+    const char* begin = chars.data();
+    return std::size_t(Escaper::find(begin, begin + chars.size()) - begin);
+}
+
+// escaped size of [p, end), where `p` is at a char that needs escaping or at `end`
+template<class Escaper>
+std::size_t escaped_size(const char* p, const char* end) {
+    std::size_t size = 0;
+    while (p != end) {
+        size += Escaper::size(*p);
+        const char* next = Escaper::find(++p, end);
+        size += std::size_t(next - p);
+        p = next;
+    }
+    return size;
+}
+
+template<class Escaper>
+char* write_escaped(const char* p, const char* end, char* out) {
+    while (p != end) {
+        out              = Escaper::write(*p, out);
+        const char* next = Escaper::find(++p, end);
+        std::memcpy(out, p, std::size_t(next - p));
+        out += next - p;
+        p = next;
+    }
+    return out;
+}
+
+// reads four hex digits at `p` into `code`
+bool read_hex4(const char* p, const char* end, std::uint32_t& code) {
+    if (end - p < 4)
+        return false;
+    code = 0;
+    for (int i = 0; i < 4; ++i) {
+        const int value = hex_value(p[i]);
+        if (value < 0)
+            return false;
+        code = code << 4 | std::uint32_t(value);
+    }
+    return true;
+}
+
+// Decoders write at most as many chars as they read, advance `out` past the decoded chars and return
+// the position of the first invalid escape sequence, or the input size.
+
+std::size_t decode_json(std::string_view in, char*& out) {
+    const char* begin = in.data();
+    const char* end   = begin + in.size();
+    const char* p     = begin;
+    while (p != end) {
+        const void* found  = std::memchr(p, '\\', std::size_t(end - p));
+        const char* escape = found ? static_cast<const char*>(found) : end;
+        std::memcpy(out, p, std::size_t(escape - p));
+        out += escape - p;
+        if (escape == end)
+            break;
+        const auto position = std::size_t(escape - begin);
+        if (end - escape < 2)
+            return position;
+        p = escape + 2;
+        switch (escape[1]) {
+        case '"': *out++ = '"'; break;
+        case '\\': *out++ = '\\'; break;
+        case '/': *out++ = '/'; break;
+        case 'b': *out++ = '\b'; break;
+        case 'f': *out++ = '\f'; break;
+        case 'n': *out++ = '\n'; break;
+        case 'r': *out++ = '\r'; break;
+        case 't': *out++ = '\t'; break;
+        case 'u': {
+            std::uint32_t code;
+            if (!read_hex4(p, end, code))
+                return position;
+            p += 4;
+            if (code >= 0xdc00 && code < 0xe000)
+                return position;
+            if (code >= 0xd800 && code < 0xdc00) {
+                // a high surrogate, which must be followed by an escaped low one
+                std::uint32_t low;
+                if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || !read_hex4(p + 2, end, low) || low < 0xdc00 || low >= 0xe000)
+                    return position;
+                code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                p += 6;
+            }
+            out = write_utf8(code, out);
+            break;
+        }
+        default: return position;
+        }
+    }
+    return in.size();
+}
+
+// decodes the entity between `&` and `;` in [p, end), returns false if it is not one
+bool decode_entity(const char* p, const char* end, char*& out) {
+    const std::string_view name(p, std::size_t(end - p));
+    if (name == "amp" || name == "lt" || name == "gt" || name == "quot" || name == "apos") {
+        *out++ = name == "amp" ? '&' : name == "lt" ? '<' : name == "gt" ? '>' : name == "quot" ? '"' : '\'';
+        return true;
+    }
+    if (name.size() < 2 || name[0] != '#')
+        return false;
+    const bool    hex    = name[1] == 'x' || name[1] == 'X';
+    const auto    digits = name.substr(hex ? 2 : 1);
+    std::uint32_t code   = 0;
+    if (digits.empty())
+        return false;
+    for (char c : digits) {
+        const int value = hex ? hex_value(c) : (c >= '0' && c <= '9' ? c - '0' : -1);
+        if (value < 0)
+            return false;
+        code = code * (hex ? 16 : 10) + std::uint32_t(value);
+        if (code > 0x10ffff)
+            return false;
+    }
+    if (code == 0 || (code >= 0xd800 && code < 0xe000))
+        return false;
+    out = write_utf8(code, out);
+    return true;
+}
+
+void decode_html(std::string_view in, char*& out) {
+    // the longest entity decoded is "&#x10FFFF;"
+    constexpr std::ptrdiff_t longest = 10;
+    const char*              end     = in.data() + in.size();
+    const char*              p       = in.data();
+    while (p != end) {
+        const void* found = std::memchr(p, '&', std::size_t(end - p));
+        const char* amp   = found ? static_cast<const char*>(found) : end;
+        std::memcpy(out, p, std::size_t(amp - p));
+        out += amp - p;
+        if (amp == end)
+            break;
+        const auto  window = std::min(longest, end - amp);
+        const void* semi   = std::memchr(amp + 1, ';', std::size_t(window - 1));
+        if (semi && decode_entity(amp + 1, static_cast<const char*>(semi), out)) {
+            p = static_cast<const char*>(semi) + 1;
+        } else {
+            *out++ = '&';
+            p      = amp + 1;
+        }
+    }
+}
+
+std::size_t decode_percent(std::string_view in, char*& out) {
+    const char* begin = in.data();
+    const char* end   = begin + in.size();
+    const char* p     = begin;
+    while (p != end) {
+        const void* found   = std::memchr(p, '%', std::size_t(end - p));
+        const char* percent = found ? static_cast<const char*>(found) : end;
+        std::memcpy(out, p, std::size_t(percent - p));
+        out += percent - p;
+        if (percent == end)
+            break;
+        const int high = end - percent > 2 ? hex_value(percent[1]) : -1;
+        const int low  = high >= 0 ? hex_value(percent[2]) : -1;
+        if (low < 0)
+            return std::size_t(percent - begin);
+        *out++ = char(high << 4 | low);
+        p      = percent + 3;
+    }
+    return in.size();
+}
+
+}
+
+template<class CheckPolicy>
+template<class Escaper>
+void BasicString<CheckPolicy>::append_escaped(std::string_view chars, std::size_t first, BasicString& out) {
+    if (out.overlaps(chars)) {
+        const BasicString copy(chars);
+        append_escaped<Escaper>(copy.view(), first, out);
+        return;
+    }
+    const char* begin = chars.data();
+    const char* end   = begin + chars.size();
+    const auto  n     = first + escaped_size<Escaper>(begin + first, end);
+    char*       write = out.append_uninitialized(n);
+    if (first != 0)
+        std::memcpy(write, begin, first);
+    write_escaped<Escaper>(begin + first, end, write + first);
+}
+
+template<class CheckPolicy>
+template<class Escaper>
+std::string_view BasicString<CheckPolicy>::escaped_view(std::string_view chars, BasicString& buffer) {
+    const auto first = first_to_escape<Escaper>(chars);
+    if (first == chars.size())
+        return chars;
+    if (buffer.overlaps(chars)) {
+        BasicString escaped;
+        append_escaped<Escaper>(chars, first, escaped);
+        buffer = std::move(escaped);
+    } else {
+        buffer.clear();
+        append_escaped<Escaper>(chars, first, buffer);
+    }
+    return buffer.view();
+}
+
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::escape_json() const {
+    BasicString result;
+    escape_json(result);
+    return result;
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::escape_json(BasicString& out) const {
+    append_escaped<JsonEscaper>(view(), first_to_escape<JsonEscaper>(view()), out);
+}
+
+template<class CheckPolicy>
+std::string_view BasicString<CheckPolicy>::escape_json(std::string_view chars, BasicString& buffer) {
+    return escaped_view<JsonEscaper>(chars, buffer);
+}
+
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::unescape_json(std::string_view json) {
+    BasicString result;
+    unescape_json(json, result);
+    return result;
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::unescape_json(std::string_view json, BasicString& out) {
+    if (out.overlaps(json)) {
+        unescape_json(BasicString(json), out);
+        return;
+    }
+    const auto  old_size = out.size();
+    char* const start    = out.append_uninitialized(json.size());
+    char*       write    = start;
+    const auto  invalid  = decode_json(json, write);
+    if (invalid != json.size()) {
+        out.set_size(old_size);
+        throw_invalid("invalid JSON escape sequence", invalid);
+    }
+    out.set_size(old_size + std::size_t(write - start));
+}
+
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::escape_html() const {
+    BasicString result;
+    escape_html(result);
+    return result;
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::escape_html(BasicString& out) const {
+    append_escaped<HtmlEscaper>(view(), first_to_escape<HtmlEscaper>(view()), out);
+}
+
+template<class CheckPolicy>
+std::string_view BasicString<CheckPolicy>::escape_html(std::string_view chars, BasicString& buffer) {
+    return escaped_view<HtmlEscaper>(chars, buffer);
+}
+
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::unescape_html(std::string_view html) {
+    BasicString result;
+    unescape_html(html, result);
+    return result;
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::unescape_html(std::string_view html, BasicString& out) {
+    if (out.overlaps(html)) {
+        unescape_html(BasicString(html), out);
+        return;
+    }
+    const auto  old_size = out.size();
+    char* const start    = out.append_uninitialized(html.size());
+    char*       write    = start;
+    decode_html(html, write);
+    out.set_size(old_size + std::size_t(write - start));
+}
+
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::percent_encode() const {
+    BasicString result;
+    percent_encode(result);
+    return result;
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::percent_encode(BasicString& out) const {
+    append_escaped<UrlEscaper>(view(), first_to_escape<UrlEscaper>(view()), out);
+}
+
+template<class CheckPolicy>
+std::string_view BasicString<CheckPolicy>::percent_encode(std::string_view chars, BasicString& buffer) {
+    return escaped_view<UrlEscaper>(chars, buffer);
+}
+
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::percent_decode(std::string_view encoded) {
+    BasicString result;
+    percent_decode(encoded, result);
+    return result;
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::percent_decode(std::string_view encoded, BasicString& out) {
+    if (out.overlaps(encoded)) {
+        percent_decode(BasicString(encoded), out);
+        return;
+    }
+    const auto  old_size = out.size();
+    char* const start    = out.append_uninitialized(encoded.size());
+    char*       write    = start;
+    const auto  invalid  = decode_percent(encoded, write);
+    if (invalid != encoded.size()) {
+        out.set_size(old_size);
+        throw_invalid("invalid percent escape", invalid);
+    }
+    out.set_size(old_size + std::size_t(write - start));
+}
+
+// the rest of BasicString is instantiated in String.cpp
+#define STRING_INSTANTIATE_ESCAPE(Policy)                                                                      \
+    template BasicString<Policy> BasicString<Policy>::escape_json() const;                                     \
+    template void                BasicString<Policy>::escape_json(BasicString&) const;                         \
+    template std::string_view    BasicString<Policy>::escape_json(std::string_view, BasicString&);             \
+    template BasicString<Policy> BasicString<Policy>::unescape_json(std::string_view);                         \
+    template void                BasicString<Policy>::unescape_json(std::string_view, BasicString&);           \
+    template BasicString<Policy> BasicString<Policy>::escape_html() const;                                     \
+    template void                BasicString<Policy>::escape_html(BasicString&) const;                         \
+    template std::string_view    BasicString<Policy>::escape_html(std::string_view, BasicString&);             \
+    template BasicString<Policy> BasicString<Policy>::unescape_html(std::string_view);                         \
+    template void                BasicString<Policy>::unescape_html(std::string_view, BasicString&);           \
+    template BasicString<Policy> BasicString<Policy>::percent_encode() const;                                  \
+    template void                BasicString<Policy>::percent_encode(BasicString&) const;                      \
+    template std::string_view    BasicString<Policy>::percent_encode(std::string_view, BasicString&);          \
+    template BasicString<Policy> BasicString<Policy>::percent_decode(std::string_view);                        \
+    template void                BasicString<Policy>::percent_decode(std::string_view, BasicString&);
+
+STRING_INSTANTIATE_ESCAPE(Checked)
+STRING_INSTANTIATE_ESCAPE(Unchecked)
+#undef STRING_INSTANTIATE_ESCAPE
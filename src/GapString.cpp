@@ -0,0 +1,184 @@
+#include "GapString.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// index of the first `needle` in `haystack` at or after `from`, or GapString::npos
+std::size_t find_in(std::string_view haystack, std::string_view needle, std::size_t from) {
+    if (from > haystack.size())
+        return GapString::npos;
+    const char* end   = haystack.data() + haystack.size();
+    const char* found = detail::find_substring(haystack.data() + from, end, needle.data(), needle.size());
+    return found == end ? GapString::npos : std::size_t(found - haystack.data());
+}
+
+}
+
+GapString::GapString(std::string_view chars)
+    : m_buffer(chars.begin(), chars.end())
+    , m_gap_begin(chars.size())
+    , m_gap_end(chars.size()) {
+}
+
+GapString::GapString(String&& string) noexcept
+    : m_buffer(std::move(string.m_chars)) {
+    // drop the terminator, and make the spare capacity the gap
+    if (!m_buffer.empty())
+        m_buffer.pop_back();
+    m_gap_begin = m_buffer.size();
+    m_buffer.resize(m_buffer.capacity());
+    m_gap_end = m_buffer.size();
+}
+
+char GapString::at(std::size_t i) const {
+    if (i >= size())
+        throw std::out_of_range("GapString index out of range");
+    return (*this)[i];
+}
+
+std::string_view GapString::view() {
+    move_gap(size());
+    return before_gap();
+}
+
+void GapString::move_gap(std::size_t position) {
+    if (position > size())
+        throw std::out_of_range("GapString position out of range");
+    char* const buffer = m_buffer.data();
+    if (position < m_gap_begin) {
+        // the chars between position and the gap move behind it
+        const auto n = m_gap_begin - position;
+        std::memmove(buffer + m_gap_end - n, buffer + position, n);
+        m_gap_begin -= n;
+        m_gap_end -= n;
+    } else if (position > m_gap_begin) {
+        const auto n = position - m_gap_begin;
+        std::memmove(buffer + m_gap_begin, buffer + m_gap_end, n);
+        m_gap_begin += n;
+        m_gap_end += n;
+    }
+}
+
+void GapString::insert(std::size_t position, std::string_view chars) {
+    if (position > size())
+        throw std::out_of_range("GapString position out of range");
+    if (chars.empty())
+        return;
+    if (overlaps(chars)) {
+        const std::string copy(chars);
+        insert(position, std::string_view(copy));
+        return;
+    }
+    move_gap(position);
+    if (gap_size() < chars.size())
+        grow_gap(chars.size());
+    std::memcpy(m_buffer.data() + m_gap_begin, chars.data(), chars.size());
+    m_gap_begin += chars.size();
+}
+
+void GapString::erase(std::size_t position, std::size_t count) {
+    if (position > size() || count > size() - position)
+        throw std::out_of_range("GapString position out of range");
+    move_gap(position);
+    m_gap_end += count;
+}
+
+void GapString::clear() noexcept {
+    m_gap_begin = 0;
+    m_gap_end   = m_buffer.size();
+}
+
+void GapString::grow_gap(std::size_t n) {
+    // at least doubling, so that growing is amortized O(1) per char
+    const auto        after = m_buffer.size() - m_gap_end;
+    const auto        capacity = std::max(2 * m_buffer.size(), size() + n + min_gap);
+    std::vector<char> buffer(capacity);
+    if (m_gap_begin != 0)
+        std::memcpy(buffer.data(), m_buffer.data(), m_gap_begin);
+    if (after != 0)
+        std::memcpy(buffer.data() + capacity - after, m_buffer.data() + m_gap_end, after);
+    m_buffer.swap(buffer);
+    m_gap_end = capacity - after;
+}
+
+bool GapString::overlaps(std::string_view chars) const noexcept {
+    return !m_buffer.empty() && chars.data() >= m_buffer.data() && chars.data() < m_buffer.data() + m_buffer.size();
+}
+
+std::size_t GapString::find(char c, std::size_t from) const noexcept {
+    if (from < m_gap_begin) {
+        const void* found = std::memchr(m_buffer.data() + from, c, m_gap_begin - from);
+        if (found)
+            return std::size_t(static_cast<const char*>(found) - m_buffer.data());
+        from = m_gap_begin;
+    }
+    const auto after = after_gap();
+    const auto start = from - m_gap_begin;
+    if (start >= after.size())
+        return npos;
+    const void* found = std::memchr(after.data() + start, c, after.size() - start);
+    return found ? m_gap_begin + std::size_t(static_cast<const char*>(found) - after.data()) : npos;
+}
+
+std::size_t GapString::find(std::string_view needle, std::size_t from) const {
+    if (needle.empty())
+        return from <= size() ? from : npos;
+    if (needle.size() == 1)
+        return find(needle[0], from);
+    if (from < m_gap_begin) {
+        const auto found = find_in(before_gap(), needle, from);
+        if (found != npos)
+            return found;
+        // matches starting before the gap and ending after it
+        const auto span_begin = std::max(from, m_gap_begin - std::min(m_gap_begin, needle.size() - 1));
+        const auto span_end   = std::min(size(), m_gap_begin + needle.size() - 1);
+        std::string window;
+        window.reserve(span_end - span_begin);
+        window.append(m_buffer.data() + span_begin, m_gap_begin - span_begin);
+        window.append(m_buffer.data() + m_gap_end, span_end - m_gap_begin);
+        const auto in_window = window.find(needle);
+        if (in_window != std::string::npos && span_begin + in_window < m_gap_begin)
+            return span_begin + in_window;
+        from = m_gap_begin;
+    }
+    const auto found = find_in(after_gap(), needle, from - m_gap_begin);
+    return found == npos ? npos : m_gap_begin + found;
+}
+
+String GapString::to_string() const {
+    String result;
+    if (empty())
+        return result;
+    result.reserve(size());
+    std::memcpy(result.append_uninitialized(size()), m_buffer.data(), m_gap_begin);
+    std::memcpy(result.data() + m_gap_begin, m_buffer.data() + m_gap_end, m_buffer.size() - m_gap_end);
+    return result;
+}
+
+String GapString::release() {
+    String result;
+    if (!empty()) {
+        move_gap(size());
+        const auto n = size();
+        // the terminator goes into the gap, if there is one
+        m_buffer.resize(n);
+        m_buffer.push_back('\0');
+        result.m_chars = std::move(m_buffer);
+    }
+    m_buffer.clear();
+    m_gap_begin = 0;
+    m_gap_end   = 0;
+    return result;
+}
+
+bool GapString::operator==(std::string_view other) const noexcept {
+    if (other.size() != size())
+        return false;
+    const auto before = before_gap();
+    return other.substr(0, before.size()) == before && other.substr(before.size()) == after_gap();
+}
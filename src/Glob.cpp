@@ -0,0 +1,297 @@
+#include "Glob.h"
+
+#include <map>
+#include <stdexcept>
+
+GlobPattern::GlobPattern(const String& pattern)
+    : GlobPattern(pattern.view()) {
+}
+
+GlobPattern::GlobPattern(const char* pattern)
+    : GlobPattern(std::string_view(pattern)) {
+}
+
+GlobPattern::GlobPattern(std::string_view pattern)
+    : m_pattern(pattern) {
+    compile();
+    build_automaton();
+}
+
+void GlobPattern::compile() {
+    const auto  p = m_pattern.view();
+    std::size_t i = 0;
+    while (i < p.size()) {
+        const char c = p[i];
+        if (c == '\\') {
+            if (i + 1 == p.size())
+                throw std::invalid_argument("glob pattern ends with an escape char");
+            m_tokens.push_back(Token { Kind::Literal, static_cast<unsigned char>(p[i + 1]), 0 });
+            i += 2;
+        } else if (c == '?') {
+            m_tokens.push_back(Token { Kind::AnyChar, 0, 0 });
+            ++i;
+        } else if (c == '[') {
+            std::size_t j      = i + 1;
+            const bool  negate = j < p.size() && (p[j] == '!' || p[j] == '^');
+            if (negate)
+                ++j;
+            const std::size_t set_begin = j;
+            std::vector<bool> members(256, false);
+            while (j < p.size() && (p[j] != ']' || j == set_begin)) {
+                auto from = static_cast<unsigned char>(p[j]);
+                auto to   = from;
+                if (j + 2 < p.size() && p[j + 1] == '-' && p[j + 2] != ']') {
+                    to = static_cast<unsigned char>(p[j + 2]);
+                    j += 2;
+                }
+                for (unsigned member = from; member <= to; ++member)
+                    members[member] = true;
+                ++j;
+            }
+            if (j == p.size())
+                throw std::invalid_argument("unterminated '[' in glob pattern");
+            if (negate)
+                members.flip();
+            members['/'] = false;
+            m_tokens.push_back(Token { Kind::Set, 0, m_sets.size() / 256 });
+            m_sets.insert(m_sets.end(), members.begin(), members.end());
+            i = j + 1;
+        } else if (c == '*') {
+            std::size_t j = i;
+            while (j < p.size() && p[j] == '*')
+                ++j;
+            if (j - i == 1) {
+                m_tokens.push_back(Token { Kind::Star, 0, 0 });
+            } else if ((i == 0 || p[i - 1] == '/') && j < p.size() && p[j] == '/') {
+                // "**/" as a whole path component, which may also match no component at all
+                m_tokens.push_back(Token { Kind::AnyDirectories, 0, 0 });
+                m_tokens.push_back(Token { Kind::InDirectories, 0, 0 });
+                ++j;
+            } else {
+                m_tokens.push_back(Token { Kind::DoubleStar, 0, 0 });
+            }
+            i = j;
+        } else {
+            m_tokens.push_back(Token { Kind::Literal, static_cast<unsigned char>(c), 0 });
+            ++i;
+        }
+    }
+
+    std::size_t stars      = 0;
+    std::size_t wildcards  = 0;
+    std::size_t star_index = 0;
+    for (std::size_t t = 0; t < m_tokens.size(); ++t) {
+        const auto kind = m_tokens[t].kind;
+        if (kind == Kind::Literal || kind == Kind::AnyChar || kind == Kind::Set)
+            ++m_min_size;
+        if (kind != Kind::Literal)
+            ++wildcards;
+        if (kind == Kind::Star) {
+            ++stars;
+            star_index = t;
+        }
+    }
+    std::size_t prefix = 0;
+    while (prefix < m_tokens.size() && m_tokens[prefix].kind == Kind::Literal)
+        m_prefix += String(static_cast<char>(m_tokens[prefix++].c));
+    m_literal = wildcards == 0;
+    if (m_literal)
+        return;
+    std::size_t suffix = m_tokens.size();
+    while (suffix > prefix && m_tokens[suffix - 1].kind == Kind::Literal)
+        --suffix;
+    for (std::size_t t = suffix; t < m_tokens.size(); ++t)
+        m_suffix += String(static_cast<char>(m_tokens[t].c));
+    m_single_star = wildcards == 1 && stars == 1 && star_index == prefix && suffix == prefix + 1;
+}
+
+bool GlobPattern::token_consumes(const Token& token, unsigned char c) const {
+    switch (token.kind) {
+    case Kind::Literal:
+        return token.c == c;
+    case Kind::AnyChar:
+        return c != '/';
+    case Kind::Set:
+        return m_sets[token.set * 256 + c];
+    default:
+        return false;
+    }
+}
+
+void GlobPattern::build_automaton() {
+    if (m_literal || m_single_star)
+        return;
+    // one bit per token, plus one for the accepting state after the last token
+    m_words = (m_tokens.size() + 1 + 63) / 64;
+    m_optional.assign(m_words, 0);
+    m_skip_two.assign(m_words, 0);
+    for (std::size_t t = 0; t < m_tokens.size(); ++t) {
+        const auto kind = m_tokens[t].kind;
+        const auto bit  = std::uint64_t(1) << (t % 64);
+        if (kind == Kind::Star || kind == Kind::DoubleStar || kind == Kind::AnyDirectories)
+            m_optional[t / 64] |= bit;
+        // entering "**/" leads inside it, or past it for zero components. Once inside, chars have
+        // been consumed, so the only way out is a '/' ending the last component.
+        if (kind == Kind::AnyDirectories)
+            m_skip_two[t / 64] |= bit;
+    }
+    std::map<std::vector<std::uint64_t>, std::uint8_t> classes;
+    for (unsigned c = 0; c < 256; ++c) {
+        std::vector<std::uint64_t> signature(m_words * 2, 0);
+        for (std::size_t t = 0; t < m_tokens.size(); ++t) {
+            const auto& token   = m_tokens[t];
+            const auto  bit     = std::uint64_t(1) << (t % 64);
+            const bool  advance = token_consumes(token, static_cast<unsigned char>(c))
+                || (token.kind == Kind::InDirectories && c == '/');
+            const bool stay = (token.kind == Kind::Star && c != '/')
+                || token.kind == Kind::DoubleStar || token.kind == Kind::InDirectories;
+            if (advance)
+                signature[t / 64] |= bit;
+            if (stay)
+                signature[m_words + t / 64] |= bit;
+        }
+        auto found = classes.find(signature);
+        if (found == classes.end()) {
+            found = classes.emplace(signature, static_cast<std::uint8_t>(classes.size())).first;
+            m_advance.insert(m_advance.end(), signature.begin(), signature.begin() + m_words);
+            m_stay.insert(m_stay.end(), signature.begin() + m_words, signature.end());
+        }
+        m_char_class[c] = found->second;
+    }
+}
+
+bool GlobPattern::run_automaton(std::string_view text) const {
+    const std::size_t accept = m_tokens.size();
+    if (m_words == 1) {
+        const std::uint64_t optional = m_optional[0];
+        const std::uint64_t skip_two = m_skip_two[0];
+        auto                closure  = [optional, skip_two](std::uint64_t states) {
+            for (;;) {
+                const auto next = states | ((states & optional) << 1) | ((states & skip_two) << 2);
+                if (next == states)
+                    return states;
+                states = next;
+            }
+        };
+        std::uint64_t states = closure(1);
+        for (char c : text) {
+            const auto cls = m_char_class[static_cast<unsigned char>(c)];
+            states         = closure(((states & m_advance[cls]) << 1) | (states & m_stay[cls]));
+            if (!states)
+                return false;
+        }
+        return (states >> accept) & 1;
+    }
+
+    std::vector<std::uint64_t> states(m_words, 0);
+    std::vector<std::uint64_t> next(m_words, 0);
+    // shifts `from & mask` left by `bits` (1 or 2) across all words and ors it into `to`
+    auto shift_into = [this](std::vector<std::uint64_t>& to, const std::vector<std::uint64_t>& from, const std::uint64_t* mask,
+                          unsigned bits = 1) {
+        std::uint64_t carry = 0;
+        for (std::size_t w = 0; w < m_words; ++w) {
+            const auto masked = from[w] & mask[w];
+            to[w] |= (masked << bits) | carry;
+            carry = masked >> (64 - bits);
+        }
+    };
+    auto closure = [&](std::vector<std::uint64_t>& s) {
+        for (;;) {
+            next = s;
+            shift_into(next, s, m_optional.data());
+            shift_into(next, s, m_skip_two.data(), 2);
+            if (next == s)
+                return;
+            s.swap(next);
+        }
+    };
+    states[0] = 1;
+    closure(states);
+    for (char c : text) {
+        const auto  cls     = m_char_class[static_cast<unsigned char>(c)];
+        const auto* advance = &m_advance[cls * m_words];
+        const auto* stay    = &m_stay[cls * m_words];
+        bool        any     = false;
+        for (std::size_t w = 0; w < m_words; ++w)
+            next[w] = states[w] & stay[w];
+        shift_into(next, states, advance);
+        states.swap(next);
+        closure(states);
+        for (auto word : states)
+            any |= word != 0;
+        if (!any)
+            return false;
+    }
+    return (states[accept / 64] >> (accept % 64)) & 1;
+}
+
+bool GlobPattern::matches(std::string_view text) const {
+    if (text.size() < m_min_size)
+        return false;
+    if (m_literal)
+        return text == m_prefix.view();
+    if (text.substr(0, m_prefix.size()) != m_prefix.view())
+        return false;
+    if (text.size() < m_suffix.size() || text.substr(text.size() - m_suffix.size()) != m_suffix.view())
+        return false;
+    if (m_single_star) {
+        if (text.size() < m_prefix.size() + m_suffix.size())
+            return false;
+        const auto middle = text.substr(m_prefix.size(), text.size() - m_prefix.size() - m_suffix.size());
+        return middle.find('/') == std::string_view::npos;
+    }
+    return run_automaton(text);
+}
+
+bool GlobPattern::match_any(const std::vector<GlobPattern>& patterns, std::string_view text) {
+    for (const auto& pattern : patterns)
+        if (pattern.matches(text))
+            return true;
+    return false;
+}
+
+GlobSet::GlobSet(const std::vector<String>& patterns) {
+    m_patterns.reserve(patterns.size());
+    for (const auto& pattern : patterns)
+        add(pattern);
+}
+
+std::size_t GlobSet::add(std::string_view pattern) {
+    GlobPattern compiled(pattern);
+    const auto  index = m_patterns.size();
+    if (compiled.m_literal)
+        m_literal_patterns.emplace(std::hash<std::string_view> {}(compiled.m_prefix.view()), index);
+    else
+        m_wildcard_patterns.push_back(index);
+    m_patterns.push_back(std::move(compiled));
+    return index;
+}
+
+bool GlobSet::match_any(std::string_view text) const {
+    return first_match(text) != npos;
+}
+
+std::size_t GlobSet::first_match(std::string_view text) const {
+    std::size_t literal = npos;
+    if (!m_literal_patterns.empty()) {
+        const auto range = m_literal_patterns.equal_range(std::hash<std::string_view> {}(text));
+        for (auto it = range.first; it != range.second; ++it)
+            if (it->second < literal && m_patterns[it->second].m_prefix.view() == text)
+                literal = it->second;
+    }
+    for (auto index : m_wildcard_patterns) {
+        if (index > literal)
+            break;
+        if (m_patterns[index].matches(text))
+            return index;
+    }
+    return literal;
+}
+
+std::vector<std::size_t> GlobSet::all_matches(std::string_view text) const {
+    std::vector<std::size_t> result;
+    for (std::size_t i = 0; i < m_patterns.size(); ++i)
+        if (m_patterns[i].matches(text))
+            result.push_back(i);
+    return result;
+}
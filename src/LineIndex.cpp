@@ -0,0 +1,156 @@
+#include "LineIndex.h"
+#include "Simd.h"
+
+#include <algorithm>
+#include <iterator>
+
+void LineIndex::rebuild(std::string_view text) {
+    m_blocks.clear();
+    m_size = text.size();
+    const char* begin = text.data();
+    const char* end   = begin + text.size();
+    Block       block { 0, {} };
+    block.newlines.reserve(std::min(detail::count_char(begin, end, '\n'), block_size));
+    detail::for_each_char(begin, end, '\n', [&](std::size_t offset) {
+        block.newlines.push_back(offset);
+        if (block.newlines.size() == block_size) {
+            m_blocks.push_back(std::move(block));
+            block = Block { 0, {} };
+            block.newlines.reserve(block_size);
+        }
+    });
+    if (!block.newlines.empty())
+        m_blocks.push_back(std::move(block));
+    renumber(0);
+}
+
+std::size_t LineIndex::line_start(std::size_t line) const {
+    if (line >= line_count())
+        throw std::out_of_range("line out of range");
+    if (line == 0)
+        return 0;
+    // line n starts behind newline n - 1
+    const auto newline = line - 1;
+    const auto block   = std::size_t(std::upper_bound(m_first.begin(), m_first.end() - 1, newline) - m_first.begin()) - 1;
+    return m_blocks[block].base + m_blocks[block].newlines[newline - m_first[block]] + 1;
+}
+
+std::size_t LineIndex::line_end(std::size_t line) const {
+    if (line >= line_count())
+        throw std::out_of_range("line out of range");
+    return line + 1 == line_count() ? m_size : line_start(line + 1) - 1;
+}
+
+std::size_t LineIndex::line_of(std::size_t offset) const {
+    if (offset > m_size)
+        throw std::out_of_range("line index offset out of range");
+    // the line is the amount of newlines before `offset`
+    const auto   block    = block_at_or_after(offset);
+    if (block == m_blocks.size())
+        return m_first.back();
+    const Block& b        = m_blocks[block];
+    const auto   in_block = std::partition_point(b.newlines.begin(), b.newlines.end(),
+        [&b, offset](std::size_t newline) { return b.base + newline < offset; });
+    return m_first[block] + std::size_t(in_block - b.newlines.begin());
+}
+
+void LineIndex::inserted(std::size_t offset, std::string_view chars) {
+    if (offset > m_size)
+        throw std::out_of_range("line index offset out of range");
+    if (chars.empty())
+        return;
+    m_size += chars.size();
+    std::vector<std::size_t> added;
+    detail::for_each_char(chars.data(), chars.data() + chars.size(), '\n', [&](std::size_t i) { added.push_back(offset + i); });
+
+    auto block = block_at_or_after(offset);
+    // the blocks behind the touched one only move
+    for (auto b = block + 1; b < m_blocks.size(); ++b)
+        m_blocks[b].base += chars.size();
+    if (block == m_blocks.size()) {
+        if (added.empty())
+            return;
+        if (m_blocks.empty())
+            m_blocks.push_back(Block { 0, {} });
+        block = m_blocks.size() - 1;
+    }
+
+    // newlines at or behind `offset` move behind the inserted chars, which bring their own
+    Block& b     = m_blocks[block];
+    auto   split = std::partition_point(b.newlines.begin(), b.newlines.end(),
+        [&b, offset](std::size_t newline) { return b.base + newline < offset; });
+    for (auto it = split; it != b.newlines.end(); ++it)
+        *it += chars.size();
+    for (auto& newline : added)
+        newline -= b.base;
+    b.newlines.insert(split, added.begin(), added.end());
+    rebalance(block);
+    renumber(block);
+}
+
+void LineIndex::erased(std::size_t offset, std::size_t count) {
+    if (offset > m_size || count > m_size - offset)
+        throw std::out_of_range("line index offset out of range");
+    if (count == 0)
+        return;
+    m_size -= count;
+    const auto first_block = block_at_or_after(offset);
+    auto       block       = first_block;
+    // blocks with newlines inside the erased chars lose them, the ones behind move
+    for (; block < m_blocks.size() && m_blocks[block].first() < offset + count; ++block) {
+        Block& b     = m_blocks[block];
+        auto   from  = std::partition_point(b.newlines.begin(), b.newlines.end(),
+            [&b, offset](std::size_t newline) { return b.base + newline < offset; });
+        auto   to    = std::partition_point(from, b.newlines.end(),
+            [&b, offset, count](std::size_t newline) { return b.base + newline < offset + count; });
+        for (auto it = to; it != b.newlines.end(); ++it)
+            *it -= count;
+        b.newlines.erase(from, to);
+    }
+    for (auto b = block; b < m_blocks.size(); ++b)
+        m_blocks[b].base -= count;
+    m_blocks.erase(std::remove_if(m_blocks.begin() + std::ptrdiff_t(first_block), m_blocks.begin() + std::ptrdiff_t(block),
+                       [](const Block& b) { return b.newlines.empty(); }),
+        m_blocks.begin() + std::ptrdiff_t(block));
+    if (first_block < m_blocks.size())
+        rebalance(first_block);
+    renumber(first_block);
+}
+
+std::size_t LineIndex::block_at_or_after(std::size_t offset) const noexcept {
+    // the first block whose last newline is at or behind `offset`
+    return std::size_t(std::partition_point(m_blocks.begin(), m_blocks.end(),
+                           [offset](const Block& b) { return b.last() < offset; })
+        - m_blocks.begin());
+}
+
+void LineIndex::rebalance(std::size_t block) {
+    Block& b = m_blocks[block];
+    if (b.newlines.size() > 2 * block_size) {
+        // a large paste can bring many blocks worth of newlines, so split into as many even pieces
+        // of at most block_size as needed, not just in half
+        const auto         n      = b.newlines.size();
+        const auto         pieces = (n + block_size - 1) / block_size;
+        std::vector<Block> back;
+        back.reserve(pieces - 1);
+        for (std::size_t piece = 1; piece < pieces; ++piece)
+            back.push_back(Block { b.base, std::vector<std::size_t>(b.newlines.begin() + std::ptrdiff_t(piece * n / pieces),
+                                               b.newlines.begin() + std::ptrdiff_t((piece + 1) * n / pieces)) });
+        b.newlines.resize(n / pieces);
+        m_blocks.insert(m_blocks.begin() + std::ptrdiff_t(block) + 1, std::make_move_iterator(back.begin()),
+            std::make_move_iterator(back.end()));
+    } else if (block + 1 < m_blocks.size() && b.newlines.size() + m_blocks[block + 1].newlines.size() <= block_size) {
+        Block& next = m_blocks[block + 1];
+        for (auto newline : next.newlines)
+            b.newlines.push_back(next.base + newline - b.base);
+        m_blocks.erase(m_blocks.begin() + std::ptrdiff_t(block) + 1);
+    }
+}
+
+void LineIndex::renumber(std::size_t from_block) {
+    m_first.resize(m_blocks.size() + 1);
+    if (from_block == 0)
+        m_first[0] = 0;
+    for (auto b = std::max<std::size_t>(from_block, 1); b <= m_blocks.size(); ++b)
+        m_first[b] = m_first[b - 1] + m_blocks[b - 1].newlines.size();
+}
@@ -0,0 +1,155 @@
+#include "ReplaceFilter.h"
+#include "Simd.h"
+#include "StringIO.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <stdexcept>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t unknown = std::size_t(-1);
+
+}
+
+ReplaceFilter::ReplaceFilter(std::string_view from, std::string_view to, std::size_t chunk_size)
+    : ReplaceFilter(std::vector<std::pair<String, String>> { { String(from), String(to) } }, chunk_size) {
+}
+
+ReplaceFilter::ReplaceFilter(const std::vector<std::pair<String, String>>& replacements, std::size_t chunk_size)
+    : m_chunk_size(chunk_size) {
+    if (replacements.empty())
+        throw std::invalid_argument("no replacements");
+    if (chunk_size == 0)
+        throw std::invalid_argument("chunk size of 0");
+    for (const auto& replacement : replacements) {
+        if (replacement.first.empty())
+            throw std::invalid_argument("empty pattern");
+        m_from.push_back(replacement.first);
+        m_to.push_back(replacement.second);
+        m_longest = std::max(m_longest, replacement.first.size());
+    }
+    m_next.resize(m_from.size());
+    m_stats.matches_per_pattern.resize(m_from.size());
+}
+
+std::size_t ReplaceFilter::scan(std::string_view data, std::size_t from, std::size_t safe_end) {
+    // replaces the matches starting in [from, safe_end), and copies everything from `from` up to
+    // safe_end or the end of the last match, whichever is further. Returns where the copy ended.
+    std::fill(m_next.begin(), m_next.end(), unknown);
+    std::size_t copied = from;
+    std::size_t pos    = from;
+    while (pos < safe_end) {
+        std::size_t best = unknown;
+        for (std::size_t i = 0; i < m_from.size(); ++i) {
+            const auto pattern = m_from[i].view();
+            if (m_next[i] == unknown || (m_next[i] != data.size() && m_next[i] < pos)) {
+                // only matches starting before safe_end count
+                const char* end   = data.data() + std::min(data.size(), safe_end + pattern.size() - 1);
+                const char* found = detail::find_substring(data.data() + pos, end, pattern.data(), pattern.size());
+                m_next[i]         = found == end ? data.size() : std::size_t(found - data.data());
+            }
+            if (m_next[i] == data.size())
+                continue;
+            if (best == unknown || m_next[i] < m_next[best] || (m_next[i] == m_next[best] && pattern.size() > m_from[best].size()))
+                best = i;
+        }
+        if (best == unknown)
+            break;
+        const auto match = m_next[best];
+        m_output.append(data.substr(copied, match - copied));
+        m_output.append(m_to[best].view());
+        ++m_stats.matches;
+        ++m_stats.matches_per_pattern[best];
+        pos = copied = match + m_from[best].size();
+    }
+    if (copied < safe_end) {
+        m_output.append(data.substr(copied, safe_end - copied));
+        copied = safe_end;
+    }
+    return copied;
+}
+
+std::string_view ReplaceFilter::process(std::string_view chunk) {
+    m_output.clear();
+    m_stats.bytes_read += chunk.size();
+    std::size_t start = 0;
+    if (!m_carry.empty()) {
+        if (chunk.size() < m_longest - 1) {
+            // too little to decide anything about the carry, so keep collecting
+            m_carry.append(chunk);
+            m_carry.erase(0, scan(m_carry, 0, safe_end(m_carry.size())));
+            m_stats.bytes_written += m_output.size();
+            return m_output;
+        }
+        // matches starting in the carry end within the first m_longest - 1 chars of the chunk, so
+        // only those are copied behind it
+        m_window.assign(m_carry);
+        m_window.append(chunk.substr(0, m_longest - 1));
+        start = scan(m_window, 0, m_carry.size()) - m_carry.size();
+        m_carry.clear();
+    }
+    const auto end = safe_end(chunk.size());
+    const auto stop = start < end ? scan(chunk, start, end) : start;
+    m_carry.assign(chunk.substr(stop));
+    m_stats.bytes_written += m_output.size();
+    return m_output;
+}
+
+std::string_view ReplaceFilter::finish() {
+    m_output.clear();
+    scan(m_carry, 0, m_carry.size());
+    m_carry.clear();
+    m_stats.bytes_written += m_output.size();
+    return m_output;
+}
+
+const ReplaceFilter::Stats& ReplaceFilter::run(std::istream& in, std::ostream& out) {
+    const auto        start = std::chrono::steady_clock::now();
+    std::vector<char> buffer(m_chunk_size);
+    auto              write = [&out](std::string_view chars) {
+        out.write(chars.data(), std::streamsize(chars.size()));
+        return bool(out);
+    };
+    bool ok = true;
+    while (ok && in) {
+        in.read(buffer.data(), std::streamsize(buffer.size()));
+        const auto n = std::size_t(in.gcount());
+        if (n == 0)
+            break;
+        ok = write(process(std::string_view(buffer.data(), n)));
+    }
+    if (ok)
+        write(finish());
+    m_stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return m_stats;
+}
+
+const ReplaceFilter::Stats& ReplaceFilter::run(int in, int out) {
+    const auto        start = std::chrono::steady_clock::now();
+    std::vector<char> buffer(m_chunk_size);
+    for (;;) {
+        const auto result = ::read(in, buffer.data(), buffer.size());
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+        if (result == 0)
+            break;
+        write_all(out, process(std::string_view(buffer.data(), std::size_t(result))));
+    }
+    write_all(out, finish());
+    m_stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return m_stats;
+}
+
+void ReplaceFilter::reset() {
+    m_carry.clear();
+    m_output.clear();
+    m_stats = Stats();
+    m_stats.matches_per_pattern.resize(m_from.size());
+}
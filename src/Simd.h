@@ -0,0 +1,332 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+// Internal helpers for the vectorized scanning paths. Not part of the public interface.
+//
+// All helpers operate on blocks of `detail::simd_width` bytes and return bitmasks where bit `i`
+// corresponds to byte `p[i]`. A scalar fallback is provided for targets without SSE2, so callers
+// never need to check for support themselves.
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STRING_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace detail {
+
+constexpr std::size_t simd_width = 16;
+
+/// \brief Index of the lowest set bit. `mask` must not be 0.
+inline unsigned lowest_bit(std::uint32_t mask) {
+    return static_cast<unsigned>(__builtin_ctz(mask));
+}
+
+/// \brief Index of the highest set bit. `mask` must not be 0.
+inline unsigned highest_bit(std::uint32_t mask) {
+    return 31u - static_cast<unsigned>(__builtin_clz(mask));
+}
+
+/// \brief Number of set bits.
+inline unsigned bit_count(std::uint32_t mask) {
+    return static_cast<unsigned>(__builtin_popcount(mask));
+}
+
+#if defined(STRING_SIMD_SSE2)
+
+inline __m128i load16(const char* p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+inline void store16(char* p, __m128i v) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+
+inline std::uint32_t movemask(__m128i v) {
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(v));
+}
+
+/// \brief Bytes in `v` that lie within ['lo', 'hi'] (as unsigned chars, hi - lo < 128).
+inline __m128i in_range(__m128i v, unsigned char lo, unsigned char hi) {
+    // shift the range to start at -128, then a single signed compare does the job
+    const __m128i shifted = _mm_add_epi8(v, _mm_set1_epi8(static_cast<char>(0x80 - lo)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(0x80 + (hi - lo) + 1)));
+}
+
+#endif
+
+/// \brief Mask of bytes in the block at `p` equal to `c`.
+inline std::uint32_t eq_mask(const char* p, char c) {
+#if defined(STRING_SIMD_SSE2)
+    return movemask(_mm_cmpeq_epi8(load16(p), _mm_set1_epi8(c)));
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < simd_width; ++i)
+        mask |= std::uint32_t(p[i] == c) << i;
+    return mask;
+#endif
+}
+
+/// \brief Mask of bytes in the block at `p` equal to any of `a`, `b`, `c` or `d`.
+inline std::uint32_t eq_any_mask(const char* p, char a, char b, char c, char d) {
+#if defined(STRING_SIMD_SSE2)
+    const __m128i v = load16(p);
+    return movemask(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(a)),
+                                              _mm_cmpeq_epi8(v, _mm_set1_epi8(b))),
+                                 _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)),
+                                              _mm_cmpeq_epi8(v, _mm_set1_epi8(d)))));
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < simd_width; ++i)
+        mask |= std::uint32_t(p[i] == a || p[i] == b || p[i] == c || p[i] == d) << i;
+    return mask;
+#endif
+}
+
+/// \brief True for the ASCII whitespace chars `' '`, `'\t'`, `'\n'`, `'\v'`, `'\f'` and `'\r'`.
+inline bool is_space(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+/// \brief Mask of ASCII whitespace bytes (see `is_space`) in the block at `p`.
+inline std::uint32_t space_mask(const char* p) {
+#if defined(STRING_SIMD_SSE2)
+    const __m128i v = load16(p);
+    return movemask(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), in_range(v, '\t', '\r')));
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < simd_width; ++i)
+        mask |= std::uint32_t(is_space(p[i])) << i;
+    return mask;
+#endif
+}
+
+/// \brief Flips the case of all chars in [lo, hi] in place, for ASCII letter ranges.
+inline void flip_case_range(char* p, char* end, char lo, char hi) {
+#if defined(STRING_SIMD_SSE2)
+    const __m128i bit = _mm_set1_epi8(0x20);
+    for (; end - p >= std::ptrdiff_t(simd_width); p += simd_width) {
+        const __m128i v = load16(p);
+        store16(p, _mm_xor_si128(v, _mm_and_si128(in_range(v, static_cast<unsigned char>(lo), static_cast<unsigned char>(hi)), bit)));
+    }
+#endif
+    for (; p != end; ++p)
+        if (*p >= lo && *p <= hi)
+            *p ^= 0x20;
+}
+
+/// \brief First position in [p, end) holding `a`, `b`, `c` or `d`, or `end` if there is none.
+/// Pass the same char more than once to search for fewer than four.
+inline const char* find_any(const char* p, const char* end, char a, char b, char c, char d) {
+    for (; end - p >= std::ptrdiff_t(simd_width); p += simd_width) {
+        const auto mask = eq_any_mask(p, a, b, c, d);
+        if (mask)
+            return p + lowest_bit(mask);
+    }
+    for (; p != end; ++p)
+        if (*p == a || *p == b || *p == c || *p == d)
+            return p;
+    return end;
+}
+
+/// \brief True for the chars a JSON string must escape: `"`, `\` and the control chars below 0x20.
+inline bool needs_json_escape(char c) {
+    return c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20;
+}
+
+/// \brief True for the chars HTML text and attribute values must escape: `&`, `<`, `>`, `"` and `'`.
+inline bool needs_html_escape(char c) {
+    return c == '&' || c == '<' || c == '>' || c == '"' || c == '\'';
+}
+
+/// \brief True for all chars except the RFC 3986 unreserved ones: ASCII letters, digits, `-`, `.`,
+/// `_` and `~`.
+inline bool needs_url_escape(char c) {
+    return !((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9')
+             || c == '-' || c == '.' || c == '_' || c == '~');
+}
+
+/// \brief Mask of bytes in the block at `p` for which `needs_json_escape` is true.
+inline std::uint32_t json_escape_mask(const char* p) {
+#if defined(STRING_SIMD_SSE2)
+    const __m128i v = load16(p);
+    return movemask(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'))),
+                                 in_range(v, 0x00, 0x1f)));
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < simd_width; ++i)
+        mask |= std::uint32_t(needs_json_escape(p[i])) << i;
+    return mask;
+#endif
+}
+
+/// \brief Mask of bytes in the block at `p` for which `needs_html_escape` is true.
+inline std::uint32_t html_escape_mask(const char* p) {
+#if defined(STRING_SIMD_SSE2)
+    const __m128i v = load16(p);
+    return movemask(_mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('&')), _mm_cmpeq_epi8(v, _mm_set1_epi8('<'))),
+                                              _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('>')), _mm_cmpeq_epi8(v, _mm_set1_epi8('"')))),
+                                 _mm_cmpeq_epi8(v, _mm_set1_epi8('\''))));
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < simd_width; ++i)
+        mask |= std::uint32_t(needs_html_escape(p[i])) << i;
+    return mask;
+#endif
+}
+
+/// \brief Mask of bytes in the block at `p` for which `needs_url_escape` is true.
+inline std::uint32_t url_escape_mask(const char* p) {
+#if defined(STRING_SIMD_SSE2)
+    const __m128i v     = load16(p);
+    const __m128i alnum = _mm_or_si128(_mm_or_si128(in_range(v, 'a', 'z'), in_range(v, 'A', 'Z')), in_range(v, '0', '9'));
+    const __m128i marks = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('-')), _mm_cmpeq_epi8(v, _mm_set1_epi8('.'))),
+                                       _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('_')), _mm_cmpeq_epi8(v, _mm_set1_epi8('~'))));
+    return ~movemask(_mm_or_si128(alnum, marks)) & 0xffffu;
+#else
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < simd_width; ++i)
+        mask |= std::uint32_t(needs_url_escape(p[i])) << i;
+    return mask;
+#endif
+}
+
+/// \brief First position in [p, end) for which `block_mask` sets a bit, or `end` if there is none.
+/// `needs` is the same test for a single char, used for the tail shorter than a block.
+template<class BlockMask, class Needs>
+inline const char* find_first_of_class(const char* p, const char* end, BlockMask block_mask, Needs needs) {
+    for (; end - p >= std::ptrdiff_t(simd_width); p += simd_width) {
+        const auto mask = block_mask(p);
+        if (mask)
+            return p + lowest_bit(mask);
+    }
+    for (; p != end; ++p)
+        if (needs(*p))
+            return p;
+    return end;
+}
+
+/// \brief First occurance of the `needle_size` chars at `needle` in [p, end), or `end` if there is none.
+///
+/// Candidates are found by comparing the first and last char of the needle against 16 positions at
+/// once, only those are then compared in full. An empty needle is found at `p`.
+inline const char* find_substring(const char* p, const char* end, const char* needle, std::size_t needle_size) {
+    if (needle_size == 0)
+        return p;
+    if (std::size_t(end - p) < needle_size)
+        return end;
+    if (needle_size == 1) {
+        const void* found = std::memchr(p, needle[0], std::size_t(end - p));
+        return found ? static_cast<const char*>(found) : end;
+    }
+    const char* last_start = end - needle_size; // last position a match may start at
+#if defined(STRING_SIMD_SSE2)
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last  = _mm_set1_epi8(needle[needle_size - 1]);
+    for (; last_start - p >= std::ptrdiff_t(simd_width) - 1; p += simd_width) {
+        auto mask = movemask(_mm_and_si128(_mm_cmpeq_epi8(load16(p), first),
+                                           _mm_cmpeq_epi8(load16(p + needle_size - 1), last)));
+        while (mask) {
+            const auto i = lowest_bit(mask);
+            if (std::memcmp(p + i + 1, needle + 1, needle_size - 2) == 0)
+                return p + i;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for (; p <= last_start; ++p)
+        if (*p == needle[0] && p[needle_size - 1] == needle[needle_size - 1]
+            && std::memcmp(p + 1, needle + 1, needle_size - 2) == 0)
+            return p;
+    return end;
+}
+
+
+/// \brief Last position in [p, end) holding `c`, or `end` if there is none.
+inline const char* rfind_char(const char* p, const char* end, char c) {
+    const char* q = end;
+    for (; q - p >= std::ptrdiff_t(simd_width); q -= simd_width) {
+        const auto mask = eq_mask(q - simd_width, c);
+        if (mask)
+            return q - simd_width + highest_bit(mask);
+    }
+    while (q != p)
+        if (*--q == c)
+            return q;
+    return end;
+}
+
+/// \brief Amount of bytes in [p, end) equal to `c`.
+inline std::size_t count_char(const char* p, const char* end, char c) {
+    std::size_t count = 0;
+    // four blocks per popcount
+    for (; end - p >= std::ptrdiff_t(4 * simd_width); p += 4 * simd_width) {
+        const std::uint64_t mask = std::uint64_t(eq_mask(p, c))
+            | std::uint64_t(eq_mask(p + simd_width, c)) << 16
+            | std::uint64_t(eq_mask(p + 2 * simd_width, c)) << 32
+            | std::uint64_t(eq_mask(p + 3 * simd_width, c)) << 48;
+        count += static_cast<std::size_t>(__builtin_popcountll(mask));
+    }
+    for (; end - p >= std::ptrdiff_t(simd_width); p += simd_width)
+        count += bit_count(eq_mask(p, c));
+    for (; p != end; ++p)
+        count += *p == c;
+    return count;
+}
+
+/// \brief Calls `visit(position)` for each byte in [p, end) equal to `c`, front to back.
+template<class Visit>
+inline void for_each_char(const char* p, const char* end, char c, Visit visit) {
+    const char* start = p;
+    for (; end - p >= std::ptrdiff_t(simd_width); p += simd_width) {
+        for (auto mask = eq_mask(p, c); mask; mask &= mask - 1)
+            visit(std::size_t(p - start) + lowest_bit(mask));
+    }
+    for (; p != end; ++p)
+        if (*p == c)
+            visit(std::size_t(p - start));
+}
+
+/// \brief Last occurance of the `needle_size` chars at `needle` in [p, end), or `end` if there is none.
+///
+/// The mirror image of `find_substring`, scanning blocks from the back. An empty needle is found at
+/// `end`.
+inline const char* rfind_substring(const char* p, const char* end, const char* needle, std::size_t needle_size) {
+    if (needle_size == 0)
+        return end;
+    if (std::size_t(end - p) < needle_size)
+        return end;
+    if (needle_size == 1)
+        return rfind_char(p, end, needle[0]);
+    // one past the last position a match may start at
+    const char* q = end - needle_size + 1;
+#if defined(STRING_SIMD_SSE2)
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last  = _mm_set1_epi8(needle[needle_size - 1]);
+    for (; q - p >= std::ptrdiff_t(simd_width); q -= simd_width) {
+        const char* block = q - simd_width;
+        auto        mask  = movemask(_mm_and_si128(_mm_cmpeq_epi8(load16(block), first),
+                                                   _mm_cmpeq_epi8(load16(block + needle_size - 1), last)));
+        while (mask) {
+            const auto i = highest_bit(mask);
+            if (std::memcmp(block + i + 1, needle + 1, needle_size - 2) == 0)
+                return block + i;
+            mask &= ~(std::uint32_t(1) << i);
+        }
+    }
+#endif
+    while (q != p) {
+        --q;
+        if (*q == needle[0] && q[needle_size - 1] == needle[needle_size - 1]
+            && std::memcmp(q + 1, needle + 1, needle_size - 2) == 0)
+            return q;
+    }
+    return end;
+}
+
+}
+
+#endif // SIMD_H
@@ -1,308 +1,705 @@
 #include "String.h"
+#include "Simd.h"
+#include "StringList.h"
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <algorithm>
 #include <iomanip>
+#include <limits>
 
-String::String() { }
-
-String::String(std::nullptr_t) { }
-
-String::String(char c) {
-    m_chars.push_back(c);
+template<class CheckPolicy>
+BasicString<CheckPolicy>::BasicString() {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Construct, nullptr);
 }
 
-String::String(const char* cstr)
-    : m_chars(cstr, cstr + std::strlen(cstr)) {
+template<class CheckPolicy>
+BasicString<CheckPolicy>::BasicString(std::nullptr_t) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Construct, nullptr);
 }
 
-String::String(String::ConstIterator from, String::ConstIterator to)
-    : m_chars(from, to) {
-}
-
-String::operator std::string() const {
-    return to_std_string();
+template<class CheckPolicy>
+BasicString<CheckPolicy>::BasicString(char c) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Construct, &m_chars);
+    STRING_INSTRUMENT_ADD(1, 0);
+    assign_chars(&c, 1);
 }
 
-String::Iterator String::begin() {
-    return m_chars.begin();
+template<class CheckPolicy>
+BasicString<CheckPolicy>::BasicString(const char* cstr) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Construct, &m_chars);
+    const auto len = std::strlen(cstr);
+    STRING_INSTRUMENT_ADD(len, 0);
+    assign_chars(cstr, len);
 }
 
-String::Iterator String::end() {
-    return m_chars.end();
+template<class CheckPolicy>
+BasicString<CheckPolicy>::BasicString(ConstIterator from, ConstIterator to) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Construct, &m_chars);
+    STRING_INSTRUMENT_ADD(to - from, 0);
+    if (from != to)
+        assign_chars(&*from, std::size_t(to - from));
 }
 
-String::ConstIterator String::begin() const {
-    return m_chars.begin();
+template<class CheckPolicy>
+BasicString<CheckPolicy>::BasicString(std::string_view view) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Construct, &m_chars);
+    STRING_INSTRUMENT_ADD(view.size(), 0);
+    assign_chars(view.data(), view.size());
 }
 
-String::ConstIterator String::end() const {
-    return m_chars.end();
+#if defined(STRING_INSTRUMENT)
+template<class CheckPolicy>
+BasicString<CheckPolicy>::BasicString(const BasicString& other) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Copy, &m_chars);
+    STRING_INSTRUMENT_ADD(other.size(), 0);
+    m_chars = other.m_chars;
 }
 
-char& String::at(std::size_t i) {
-    return m_chars.at(i);
+template<class CheckPolicy>
+BasicString<CheckPolicy>::BasicString(BasicString&& other) noexcept {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Move, nullptr);
+    m_chars = std::move(other.m_chars);
 }
 
-bool String::empty() const noexcept {
-    return m_chars.empty();
+template<class CheckPolicy>
+BasicString<CheckPolicy>& BasicString<CheckPolicy>::operator=(const BasicString& other) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Copy, &m_chars);
+    STRING_INSTRUMENT_ADD(other.size(), 0);
+    m_chars = other.m_chars;
+    return *this;
 }
 
-std::size_t String::size() const noexcept {
-    return m_chars.size();
+template<class CheckPolicy>
+BasicString<CheckPolicy>& BasicString<CheckPolicy>::operator=(BasicString&& other) noexcept {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Move, nullptr);
+    m_chars = std::move(other.m_chars);
+    return *this;
 }
+#endif
 
-std::size_t String::length() const noexcept {
-    return m_chars.size();
+template<class CheckPolicy>
+BasicString<CheckPolicy>::operator std::string() const {
+    return to_std_string();
 }
 
-char String::at(std::size_t i) const {
-    return m_chars.at(i);
+template<class CheckPolicy>
+BasicString<CheckPolicy>::operator std::string_view() const noexcept {
+    return view();
 }
 
-std::unique_ptr<char[]> String::to_c_string() const {
-    auto ptr = std::unique_ptr<char[]>(new char[m_chars.size() + 1]);
-    std::copy_n(m_chars.data(), m_chars.size(), ptr.get());
-    ptr.get()[m_chars.size()] = '\0';
+template<class CheckPolicy>
+std::unique_ptr<char[]> BasicString<CheckPolicy>::to_c_string() const {
+    auto ptr = std::unique_ptr<char[]>(new char[size() + 1]);
+    std::copy_n(m_chars.data(), size(), ptr.get());
+    ptr.get()[size()] = '\0';
     return ptr;
 }
 
-std::string String::to_std_string() const {
-    return std::string(m_chars.begin(), m_chars.end());
+template<class CheckPolicy>
+std::string BasicString<CheckPolicy>::to_std_string() const {
+    return std::string(m_chars.data(), size());
 }
 
-void String::clear() noexcept {
-    m_chars.clear();
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::clear() noexcept {
+    // keep the '\0' so data() stays terminated. The buffer is kept, so this never allocates.
+    if (!m_chars.empty()) {
+        m_chars.resize(1);
+        m_chars[0] = '\0';
+    }
 }
 
-void String::insert(String::ConstIterator iter, const String& s) {
-    if (iter > end())
-        throw std::runtime_error("iterator out of range");
-    m_chars.insert(iter, s.begin(), s.end());
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::insert(ConstIterator iter, const BasicString& s) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Insert, &m_chars);
+    CheckPolicy::check_iterator(iter <= end());
+    STRING_INSTRUMENT_ADD(s.size() + (end() - iter), 0);
+    insert_chars(std::size_t(iter - begin()), s.view());
 }
 
-void String::insert(String::ConstIterator iter, String::ConstIterator begin, String::ConstIterator end) {
-    if (iter > this->end())
-        throw std::runtime_error("iterator out of range");
-    m_chars.insert(iter, begin, end);
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::insert(ConstIterator iter, ConstIterator begin, ConstIterator end) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Insert, &m_chars);
+    CheckPolicy::check_iterator(iter <= this->end());
+    STRING_INSTRUMENT_ADD((end - begin) + (this->end() - iter), 0);
+    insert_chars(std::size_t(iter - this->begin()), std::string_view(begin == end ? nullptr : &*begin, std::size_t(end - begin)));
 }
 
-void String::insert(String::ConstIterator iter, char c) {
-    if (iter > end())
-        throw std::runtime_error("iterator out of range");
-    m_chars.insert(iter, c);
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::insert(ConstIterator iter, char c) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Insert, &m_chars);
+    CheckPolicy::check_iterator(iter <= end());
+    STRING_INSTRUMENT_ADD(1 + (end() - iter), 0);
+    insert_chars(std::size_t(iter - begin()), std::string_view(&c, 1));
 }
 
-void String::erase(String::ConstIterator iter) {
-    if (iter < begin() || iter > end() || empty() || iter == end())
-        throw std::runtime_error("iterator out of range");
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::erase(ConstIterator iter) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Erase, &m_chars);
+    CheckPolicy::check_iterator(iter >= begin() && iter < end());
+    STRING_INSTRUMENT_ADD(end() - iter, 0);
     m_chars.erase(iter);
 }
 
-void String::erase(String::ConstIterator from, String::ConstIterator to) {
-    if (from < begin() || from > end() || empty() || from == end() || to < begin() || to > end() || to < from)
-        throw std::runtime_error("iterator out of range");
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::erase(ConstIterator from, ConstIterator to) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Erase, &m_chars);
+    CheckPolicy::check_iterator(from >= begin() && from < end() && to >= from && to <= end());
+    STRING_INSTRUMENT_ADD(end() - to, 0);
     m_chars.erase(from, to);
 }
 
-void String::erase(String::ConstIterator iter, std::size_t n) {
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::erase(ConstIterator iter, std::size_t n) {
     erase(iter, iter + n);
 }
 
-String String::substring(String::ConstIterator from, String::ConstIterator to) const {
-    return String(from, to);
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::substring(ConstIterator from, ConstIterator to) const {
+    return BasicString(from, to);
 }
 
-String String::substring(String::ConstIterator start, std::size_t n) const {
-    return String(start, start + n);
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::substring(ConstIterator start, std::size_t n) const {
+    return BasicString(start, start + n);
 }
 
-String::Iterator String::find(char c) {
-    return std::find(m_chars.begin(), m_chars.end(), c);
+template<class CheckPolicy>
+typename BasicString<CheckPolicy>::Iterator BasicString<CheckPolicy>::find(char c) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
+    return std::find(begin(), end(), c);
 }
 
-String::ConstIterator String::find(char c) const {
-    return std::find(m_chars.begin(), m_chars.end(), c);
+template<class CheckPolicy>
+typename BasicString<CheckPolicy>::ConstIterator BasicString<CheckPolicy>::find(char c) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
+    return std::find(begin(), end(), c);
 }
 
-String::Iterator String::find(char c, String::Iterator start) {
-    return std::find(start, m_chars.end(), c);
+template<class CheckPolicy>
+typename BasicString<CheckPolicy>::Iterator BasicString<CheckPolicy>::find(char c, Iterator start) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
+    return std::find(start, end(), c);
 }
 
-String::ConstIterator String::find(char c, String::ConstIterator start) const {
-    return std::find(start, m_chars.end(), c);
+template<class CheckPolicy>
+typename BasicString<CheckPolicy>::ConstIterator BasicString<CheckPolicy>::find(char c, ConstIterator start) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
+    return std::find(start, end(), c);
 }
 
-String::Iterator String::find(const String& str) {
+template<class CheckPolicy>
+typename BasicString<CheckPolicy>::Iterator BasicString<CheckPolicy>::find(const BasicString& str) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
     return std::search(begin(), end(), str.begin(), str.end());
 }
 
-String::ConstIterator String::find(const String& str) const {
+template<class CheckPolicy>
+typename BasicString<CheckPolicy>::ConstIterator BasicString<CheckPolicy>::find(const BasicString& str) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
     return std::search(begin(), end(), str.begin(), str.end());
 }
 
-String::Iterator String::find(const String& str, Iterator start) {
+template<class CheckPolicy>
+typename BasicString<CheckPolicy>::Iterator BasicString<CheckPolicy>::find(const BasicString& str, Iterator start) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
     return std::search(start, end(), str.begin(), str.end());
 }
 
-String::ConstIterator String::find(const String& str, String::ConstIterator start) const {
+template<class CheckPolicy>
+typename BasicString<CheckPolicy>::ConstIterator BasicString<CheckPolicy>::find(const BasicString& str, ConstIterator start) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
     return std::search(start, end(), str.begin(), str.end());
 }
 
-bool String::contains(const String& str) const {
+namespace {
+
+// calls `visit(index)` for each non-overlapping occurance of `needle` in `haystack`, front to back
+template<class Visit>
+void for_each_match(std::string_view haystack, std::string_view needle, Visit visit) {
+    if (needle.empty())
+        throw std::runtime_error("empty needle");
+    const char* start = haystack.data();
+    const char* end   = start + haystack.size();
+    for (const char* p = start;;) {
+        p = detail::find_substring(p, end, needle.data(), needle.size());
+        if (p == end)
+            return;
+        visit(std::size_t(p - start));
+        p += needle.size();
+    }
+}
+
+}
+
+template<class CheckPolicy>
+typename BasicString<CheckPolicy>::Iterator BasicString<CheckPolicy>::rfind(char c) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
+    const char* data = m_chars.data();
+    return begin() + (detail::rfind_char(data, data + size(), c) - data);
+}
+
+template<class CheckPolicy>
+typename BasicString<CheckPolicy>::ConstIterator BasicString<CheckPolicy>::rfind(char c) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
+    const char* data = m_chars.data();
+    return begin() + (detail::rfind_char(data, data + size(), c) - data);
+}
+
+template<class CheckPolicy>
+typename BasicString<CheckPolicy>::Iterator BasicString<CheckPolicy>::rfind(std::string_view str) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
+    if (str.empty())
+        return end();
+    const char* data = m_chars.data();
+    return begin() + (detail::rfind_substring(data, data + size(), str.data(), str.size()) - data);
+}
+
+template<class CheckPolicy>
+typename BasicString<CheckPolicy>::ConstIterator BasicString<CheckPolicy>::rfind(std::string_view str) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
+    if (str.empty())
+        return end();
+    const char* data = m_chars.data();
+    return begin() + (detail::rfind_substring(data, data + size(), str.data(), str.size()) - data);
+}
+
+template<class CheckPolicy>
+std::size_t BasicString<CheckPolicy>::count(char c) const noexcept {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
+    return detail::count_char(m_chars.data(), m_chars.data() + size(), c);
+}
+
+template<class CheckPolicy>
+std::size_t BasicString<CheckPolicy>::count(std::string_view str) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
+    if (str.size() == 1)
+        return count(str[0]);
+    std::size_t count = 0;
+    for_each_match(view(), str, [&count](std::size_t) { ++count; });
+    return count;
+}
+
+template<class CheckPolicy>
+std::size_t BasicString<CheckPolicy>::find_all(char c, std::vector<std::size_t>& positions) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
+    positions.clear();
+    detail::for_each_char(m_chars.data(), m_chars.data() + size(), c, [&positions](std::size_t i) { positions.push_back(i); });
+    return positions.size();
+}
+
+template<class CheckPolicy>
+std::size_t BasicString<CheckPolicy>::find_all(std::string_view str, std::vector<std::size_t>& positions) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Find, nullptr);
+    positions.clear();
+    for_each_match(view(), str, [&positions](std::size_t i) { positions.push_back(i); });
+    return positions.size();
+}
+
+template<class CheckPolicy>
+bool BasicString<CheckPolicy>::contains(const BasicString& str) const {
     if (str.size() > size())
         return false;
     return find(str) != end();
 }
 
-bool String::startswith(const String& str) const {
+template<class CheckPolicy>
+bool BasicString<CheckPolicy>::startswith(const BasicString& str) const {
     if (str.size() > size())
         return false;
     return std::equal(begin(), begin() + str.size(), str.begin(), str.end());
 }
 
-bool String::endswith(const String& str) const {
+template<class CheckPolicy>
+bool BasicString<CheckPolicy>::endswith(const BasicString& str) const {
     if (str.size() > size())
         return false;
     return std::equal(end() - str.size(), end(), str.begin(), str.end());
 }
 
-bool String::equals(const String& str) const {
+template<class CheckPolicy>
+bool BasicString<CheckPolicy>::equals(const BasicString& str) const {
     if (size() != str.size())
         return false;
     return std::equal(begin(), end(), str.begin(), str.end());
 }
 
-bool String::operator==(const String& s) const {
+template<class CheckPolicy>
+bool BasicString<CheckPolicy>::operator==(const BasicString& s) const {
     return equals(s);
 }
 
-bool String::operator!=(const String& s) const {
+template<class CheckPolicy>
+bool BasicString<CheckPolicy>::operator!=(const BasicString& s) const {
     return !equals(s);
 }
 
-String& String::operator+=(const String& s) {
+template<class CheckPolicy>
+BasicString<CheckPolicy>& BasicString<CheckPolicy>::operator+=(const BasicString& s) {
     insert(end(), s);
     return *this;
 }
 
-String String::operator+(const String& s) const {
-    String result = *this;
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::operator+(const BasicString& s) const {
+    BasicString result;
+    result.reserve(size() + s.size());
+    result.insert(result.end(), *this);
     result.insert(result.end(), s);
     return result;
 }
 
-void String::replace(char to_replace, char replace_with) {
-    for (auto& c : m_chars)
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::replace(char to_replace, char replace_with) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Replace, nullptr);
+    for (auto& c : *this)
         if (c == to_replace)
             c = replace_with;
 }
 
-void String::replace(const String& to_replace, const String& replace_with) {
-    if (!to_replace.empty() && replace_with.find(to_replace) != replace_with.end())
-        throw std::invalid_argument("replace_with shall not contain to_replace");
-    Iterator iter;
-    do {
-        iter = std::search(begin(), end(), to_replace.begin(), to_replace.end());
-        if (iter != end()) {
-            erase(iter, to_replace.size());
-            insert(iter, replace_with);
-        }
-    } while (iter != end());
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::replace(const BasicString& to_replace, const BasicString& replace_with) {
+    replace(to_replace, replace_with, std::numeric_limits<std::size_t>::max());
 }
 
-void String::replace(const String& to_replace, const String& replace_with, std::size_t n) {
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::replace(const BasicString& to_replace, const BasicString& replace_with, std::size_t n) {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Replace, nullptr);
     if (!to_replace.empty() && replace_with.find(to_replace) != replace_with.end())
         throw std::invalid_argument("replace_with shall not contain to_replace");
-    Iterator    iter;
-    std::size_t i = 0;
-    do {
-        if (i >= n)
-            break;
-        ++i;
-        iter = std::search(begin(), end(), to_replace.begin(), to_replace.end());
-        if (iter != end()) {
-            erase(iter, to_replace.size());
-            insert(iter, replace_with);
+    if (to_replace.empty() || n == 0)
+        return;
+    const char* const begin = m_chars.data();
+    const char* const end   = begin + size();
+    const auto        find_next = [&](const char* from) {
+        return detail::find_substring(from, end, to_replace.data(), to_replace.size());
+    };
+
+    if (to_replace.size() == replace_with.size()) {
+        // same size, overwrite in place
+        std::size_t i = 0;
+        for (auto* match = find_next(begin); match != end && i < n; match = find_next(match + to_replace.size()), ++i) {
+            STRING_INSTRUMENT_ADD(replace_with.size(), 0);
+            std::memcpy(m_chars.data() + (match - begin), replace_with.data(), replace_with.size());
         }
-    } while (iter != end());
+        return;
+    }
+
+    // one pass to find the size of the result, a second one to build it, so that every char
+    // is copied exactly once
+    std::size_t matches = 0;
+    for (auto* match = find_next(begin); match != end && matches < n; match = find_next(match + to_replace.size()))
+        ++matches;
+    if (matches == 0)
+        return;
+    std::vector<char> result;
+    result.reserve(size() - matches * to_replace.size() + matches * replace_with.size() + 1);
+    STRING_INSTRUMENT_ADD(result.capacity(), 1);
+    const char* copied = begin;
+    std::size_t i      = 0;
+    for (auto* match = find_next(begin); match != end && i < matches; match = find_next(match + to_replace.size()), ++i) {
+        result.insert(result.end(), copied, match);
+        result.insert(result.end(), replace_with.begin(), replace_with.end());
+        copied = match + to_replace.size();
+    }
+    result.insert(result.end(), copied, end);
+    result.push_back('\0');
+    m_chars.swap(result);
 }
 
-std::vector<String> String::split(char delim, std::size_t expected_splits) const {
-    std::vector<String> result;
+template<class CheckPolicy>
+std::vector<BasicString<CheckPolicy>> BasicString<CheckPolicy>::split(char delim, std::size_t expected_splits) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Split, nullptr);
+    std::vector<BasicString> result;
     result.reserve(expected_splits);
+    STRING_INSTRUMENT_ADD(0, expected_splits != 0);
     // FIXME: is this undefined?
     auto last_iter = begin() - 1;
     auto iter      = find(delim);
     while (last_iter != end()) {
         // +1 skips the delimiter itself
-        result.push_back(String(last_iter + 1, iter));
+        result.push_back(BasicString(last_iter + 1, iter));
         last_iter = iter;
         iter      = find(delim, iter + 1);
     }
     return result;
 }
 
-std::vector<String> String::split(const String& delim, std::size_t expected_splits) const {
+template<class CheckPolicy>
+std::vector<BasicString<CheckPolicy>> BasicString<CheckPolicy>::split(const BasicString& delim, std::size_t expected_splits) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Split, nullptr);
     if (delim.empty())
         throw std::runtime_error("empty delimiter");
-    std::vector<String> result;
+    std::vector<BasicString> result;
     result.reserve(expected_splits);
+    STRING_INSTRUMENT_ADD(0, expected_splits != 0);
     // FIXME: is this undefined?
     auto last_iter = begin() - delim.size();
     auto iter      = find(delim);
     while (last_iter != end()) {
         // + delim.size() skips the delimiter itself
-        result.push_back(String(last_iter + delim.size(), iter));
+        result.push_back(BasicString(last_iter + delim.size(), iter));
         last_iter = iter;
         iter      = find(delim, iter + delim.size());
     }
     return result;
 }
 
-void String::reserve(std::size_t size) {
-    m_chars.reserve(size);
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::split_into(StringList& out, char delim) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Split, nullptr);
+    out.clear();
+    out.reserve(0, size());
+    const char* part = m_chars.data();
+    const char* end  = part + size();
+    for (;;) {
+        const void* found = part == end ? nullptr : std::memchr(part, delim, std::size_t(end - part));
+        const char* delim_pos = found ? static_cast<const char*>(found) : end;
+        out.push_back(std::string_view(part, std::size_t(delim_pos - part)));
+        if (delim_pos == end)
+            break;
+        part = delim_pos + 1;
+    }
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::split_into(StringList& out, const BasicString& delim) const {
+    STRING_INSTRUMENT_SCOPE(StringOperation::Split, nullptr);
+    if (delim.empty())
+        throw std::runtime_error("empty delimiter");
+    out.clear();
+    out.reserve(0, size());
+    const char* part = m_chars.data();
+    const char* end  = part + size();
+    for (;;) {
+        const char* delim_pos = detail::find_substring(part, end, delim.data(), delim.size());
+        out.push_back(std::string_view(part, std::size_t(delim_pos - part)));
+        if (delim_pos == end)
+            break;
+        part = delim_pos + delim.size();
+    }
 }
 
-std::size_t String::capacity() const {
-    return m_chars.capacity();
+template<class CheckPolicy>
+BasicString<CheckPolicy> BasicString<CheckPolicy>::join(const BasicString& separator, std::initializer_list<std::string_view> pieces) {
+    BasicString result;
+    join_to(result, separator, pieces);
+    return result;
 }
 
-void String::shrink_to_fit() noexcept {
-    m_chars.shrink_to_fit();
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::to_lower() noexcept {
+    detail::flip_case_range(m_chars.data(), m_chars.data() + size(), 'A', 'Z');
 }
 
-char* String::data() noexcept {
-    return m_chars.data();
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::to_upper() noexcept {
+    detail::flip_case_range(m_chars.data(), m_chars.data() + size(), 'a', 'z');
 }
 
-const char* String::data() const noexcept {
-    return m_chars.data();
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::trim() {
+    const auto trimmed = trim_view();
+    const auto front   = static_cast<std::size_t>(trimmed.data() - m_chars.data());
+    set_size(front + trimmed.size());
+    m_chars.erase(m_chars.begin(), m_chars.begin() + front);
 }
 
-std::ostream& operator<<(std::ostream& os, const String& s) {
-    return os << s.to_std_string();
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::ltrim() {
+    const auto trimmed = ltrim_view();
+    m_chars.erase(m_chars.begin(), m_chars.begin() + (trimmed.data() - m_chars.data()));
 }
 
-std::istream& operator>>(std::istream& is, String& s) {
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::rtrim() {
+    set_size(rtrim_view().size());
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::strip(const BasicString& chars) {
+    const auto stripped = strip_view(chars);
+    const auto front    = static_cast<std::size_t>(stripped.data() - m_chars.data());
+    set_size(front + stripped.size());
+    m_chars.erase(m_chars.begin(), m_chars.begin() + front);
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::collapse_whitespace() {
+    char*       write = m_chars.data();
+    const char* read  = m_chars.data();
+    const char* end   = m_chars.data() + size();
+    while (read != end) {
+        // copy the run of non-whitespace, finding its end a block at a time
+        const char* run = read;
+        for (;;) {
+            if (end - read >= std::ptrdiff_t(detail::simd_width)) {
+                const auto mask = detail::space_mask(read);
+                if (!mask) {
+                    read += detail::simd_width;
+                    continue;
+                }
+                read += detail::lowest_bit(mask);
+            } else {
+                while (read != end && !detail::is_space(*read))
+                    ++read;
+            }
+            break;
+        }
+        if (write != run)
+            std::memmove(write, run, static_cast<std::size_t>(read - run));
+        write += read - run;
+        if (read == end)
+            break;
+        // replace the run of whitespace by one space
+        *write++ = ' ';
+        while (read != end && detail::is_space(*read))
+            ++read;
+    }
+    set_size(static_cast<std::size_t>(write - m_chars.data()));
+}
+
+template<class CheckPolicy>
+std::string_view BasicString<CheckPolicy>::trim_view() const noexcept {
+    const char* first = m_chars.data();
+    const char* last  = m_chars.data() + size();
+    while (first != last && detail::is_space(*first))
+        ++first;
+    while (last != first && detail::is_space(last[-1]))
+        --last;
+    return std::string_view(first, static_cast<std::size_t>(last - first));
+}
+
+template<class CheckPolicy>
+std::string_view BasicString<CheckPolicy>::ltrim_view() const noexcept {
+    const char* first = m_chars.data();
+    const char* last  = m_chars.data() + size();
+    while (first != last && detail::is_space(*first))
+        ++first;
+    return std::string_view(first, static_cast<std::size_t>(last - first));
+}
+
+template<class CheckPolicy>
+std::string_view BasicString<CheckPolicy>::rtrim_view() const noexcept {
+    const char* first = m_chars.data();
+    const char* last  = m_chars.data() + size();
+    while (last != first && detail::is_space(last[-1]))
+        --last;
+    return std::string_view(first, static_cast<std::size_t>(last - first));
+}
+
+template<class CheckPolicy>
+std::string_view BasicString<CheckPolicy>::strip_view(const BasicString& chars) const noexcept {
+    bool in_set[256] = {};
+    for (char c : chars)
+        in_set[static_cast<unsigned char>(c)] = true;
+    const char* first = m_chars.data();
+    const char* last  = m_chars.data() + size();
+    while (first != last && in_set[static_cast<unsigned char>(*first)])
+        ++first;
+    while (last != first && in_set[static_cast<unsigned char>(last[-1])])
+        --last;
+    return std::string_view(first, static_cast<std::size_t>(last - first));
+}
+
+template<class CheckPolicy>
+char* BasicString<CheckPolicy>::append_uninitialized(std::size_t n) {
+    const auto old_size = size();
+    set_size(old_size + n);
+    return m_chars.data() + old_size;
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::insert_chars(std::size_t index, std::string_view chars) {
+    if (chars.empty())
+        return;
+    if (overlaps(chars)) {
+        insert_chars(index, BasicString(chars).view());
+        return;
+    }
+    make_room(size() + chars.size());
+    if (m_chars.empty())
+        m_chars.push_back('\0');
+    m_chars.insert(m_chars.begin() + std::ptrdiff_t(index), chars.begin(), chars.end());
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::set_size(std::size_t n) {
+    if (n == size())
+        return;
+    make_room(n);
+    m_chars.resize(n + 1);
+    m_chars[n] = '\0';
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::assign_chars(const char* chars, std::size_t n) {
+    m_chars.clear();
+    if (n == 0)
+        return;
+    make_room(n);
+    m_chars.assign(chars, chars + n);
+    m_chars.push_back('\0');
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::make_room(std::size_t n) {
+    if (n + 1 > m_chars.capacity())
+        m_chars.reserve(std::max(n + 1, 2 * m_chars.capacity()));
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::reserve(std::size_t size) {
+    if (size != 0 && size + 1 > m_chars.capacity())
+        m_chars.reserve(size + 1);
+}
+
+template<class CheckPolicy>
+void BasicString<CheckPolicy>::shrink_to_fit() noexcept {
+    m_chars.shrink_to_fit();
+}
+
+std::ostream& StringBase::write_to(std::ostream& os, std::string_view chars) {
+    // same as inserting a std::string, including width and fill, but without copying into one
+    const std::ostream::sentry sentry(os);
+    if (!sentry)
+        return os;
+    const auto size    = static_cast<std::streamsize>(chars.size());
+    const auto padding = os.width() > size ? os.width() - size : 0;
+    const bool left    = (os.flags() & std::ios::adjustfield) == std::ios::left;
+    auto       pad     = [&os, padding] {
+        for (std::streamsize i = 0; i < padding; ++i)
+            if (std::char_traits<char>::eq_int_type(os.rdbuf()->sputc(os.fill()), std::char_traits<char>::eof()))
+                return false;
+        return true;
+    };
+    bool ok = left || pad();
+    ok      = ok && os.rdbuf()->sputn(chars.data(), size) == size;
+    ok      = ok && (!left || pad());
+    os.width(0);
+    if (!ok)
+        os.setstate(std::ios::badbit);
+    return os;
+}
+
+template<class CheckPolicy>
+std::istream& BasicString<CheckPolicy>::read_from(std::istream& is) {
     const auto len = is.rdbuf()->pubseekoff(0, std::ios::end);
     is.rdbuf()->pubseekoff(0, std::ios::beg);
-    const auto offset = s.m_chars.size();
-    s.m_chars.resize(s.m_chars.size() + len);
-    auto ret = is.rdbuf()->sgetn(s.m_chars.data() + offset, len);
+    auto ret = is.rdbuf()->sgetn(append_uninitialized(std::size_t(len)), len);
     static_cast<void>(ret);
     is.rdbuf()->pubseekoff(0, std::ios::end);
     return is;
 }
 
-std::ostream& operator<<(std::ostream& os, const String::Format& fmt) {
+std::ostream& operator<<(std::ostream& os, const StringBase::Format& fmt) {
     switch (fmt.alignment) {
-    case String::Format::Align::Left:
+    case StringBase::Format::Align::Left:
         os << std::left;
         break;
-    case String::Format::Align::Right:
+    case StringBase::Format::Align::Right:
         os << std::right;
     }
 
@@ -313,3 +710,6 @@ std::ostream& operator<<(std::ostream& os, const String::Format& fmt) {
 
     return os;
 }
+
+template class BasicString<Checked>;
+template class BasicString<Unchecked>;
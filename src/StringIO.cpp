@@ -0,0 +1,95 @@
+#include "StringIO.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <string>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+void detail::IovecWriter::flush() {
+    iovec*      group = m_group;
+    std::size_t count = m_count;
+    while (count != 0) {
+        const auto result = ::writev(m_fd, group, static_cast<int>(count));
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "writev");
+        }
+        m_written += static_cast<std::size_t>(result);
+        // skip what was written, and continue in the middle of a partially written piece
+        auto done = static_cast<std::size_t>(result);
+        while (count != 0 && done >= group->iov_len) {
+            done -= group->iov_len;
+            ++group;
+            --count;
+        }
+        if (count != 0) {
+            group->iov_base = static_cast<char*>(group->iov_base) + done;
+            group->iov_len -= done;
+        }
+    }
+    m_count = 0;
+}
+
+std::size_t write_all(int fd, std::string_view data) {
+    std::size_t written = 0;
+    while (written < data.size()) {
+        const auto result = ::write(fd, data.data() + written, data.size() - written);
+        if (result < 0) {
+            if (errno == EINTR)
+                continue;
+            throw std::system_error(errno, std::generic_category(), "write");
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    return written;
+}
+
+MappedFile::MappedFile(const char* path) {
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), std::string("open ") + path);
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::system_error(error, std::generic_category(), "fstat");
+    }
+    const auto size = static_cast<std::size_t>(info.st_size);
+    if (size != 0) {
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "mmap");
+        }
+        m_data = static_cast<const char*>(data);
+        m_size = size;
+    }
+    // the mapping stays valid without the descriptor
+    ::close(fd);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr))
+    , m_size(std::exchange(other.m_size, 0)) {
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        if (m_data)
+            ::munmap(const_cast<char*>(m_data), m_size);
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    if (m_data)
+        ::munmap(const_cast<char*>(m_data), m_size);
+}
@@ -0,0 +1,217 @@
+#include "StringInstrument.h"
+#include "String.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <mutex>
+
+namespace {
+
+struct AtomicStats {
+    std::atomic<std::uint64_t> calls { 0 };
+    std::atomic<std::uint64_t> bytes_copied { 0 };
+    std::atomic<std::uint64_t> allocations { 0 };
+    std::atomic<std::uint64_t> reallocations { 0 };
+    std::atomic<std::uint64_t> nanoseconds { 0 };
+};
+
+using AtomicStatsArray = std::array<AtomicStats, std::size_t(StringOperation::Count)>;
+
+#if defined(STRING_INSTRUMENT)
+// only the owning thread writes, so a relaxed load + store is enough and avoids locked instructions
+void bump(std::atomic<std::uint64_t>& counter, std::uint64_t n) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+#endif
+
+// adds what the counters of `from` gained since they were `baseline`
+void accumulate(StringOperationStats& to, const AtomicStats& from, const StringOperationStats& baseline = {}) {
+    to.calls += from.calls.load(std::memory_order_relaxed) - baseline.calls;
+    to.bytes_copied += from.bytes_copied.load(std::memory_order_relaxed) - baseline.bytes_copied;
+    to.allocations += from.allocations.load(std::memory_order_relaxed) - baseline.allocations;
+    to.reallocations += from.reallocations.load(std::memory_order_relaxed) - baseline.reallocations;
+    to.nanoseconds += from.nanoseconds.load(std::memory_order_relaxed) - baseline.nanoseconds;
+}
+
+struct ThreadStats;
+
+struct Registry {
+    std::mutex                mutex;
+    std::vector<ThreadStats*> threads;
+    StringStats               retired;
+};
+
+Registry& registry() {
+    // leaked on purpose, threads may exit after static destruction has begun
+    static auto* instance = new Registry;
+    return *instance;
+}
+
+struct ThreadStats {
+    // only ever written by the owning thread
+    AtomicStatsArray stats;
+    // the counters at the last reset, which are subtracted from them. Written by reset instead of the
+    // counters, so a reset cannot be overwritten by the owning thread. Guarded by the registry mutex.
+    StringStats      baseline;
+
+    ThreadStats() {
+        auto&                       r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.threads.push_back(this);
+    }
+
+    ~ThreadStats() {
+        auto&                       r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (std::size_t i = 0; i < stats.size(); ++i)
+            accumulate(r.retired[StringOperation(i)], stats[i], baseline[StringOperation(i)]);
+        r.threads.erase(std::remove(r.threads.begin(), r.threads.end(), this), r.threads.end());
+    }
+};
+
+#if defined(STRING_INSTRUMENT)
+thread_local ThreadStats              t_stats;
+thread_local detail::InstrumentScope* t_current_scope = nullptr;
+
+std::uint64_t now_ns() {
+    return std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+                             .count());
+}
+#endif
+
+}
+
+StringStats StringStats::snapshot() {
+    auto&                       r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    StringStats                 result = r.retired;
+    for (auto* thread : r.threads)
+        for (std::size_t i = 0; i < thread->stats.size(); ++i)
+            accumulate(result[StringOperation(i)], thread->stats[i], thread->baseline[StringOperation(i)]);
+    return result;
+}
+
+void StringStats::reset() {
+    auto&                       r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired = StringStats {};
+    for (auto* thread : r.threads) {
+        thread->baseline = StringStats {};
+        for (std::size_t i = 0; i < thread->stats.size(); ++i)
+            accumulate(thread->baseline[StringOperation(i)], thread->stats[i]);
+    }
+}
+
+const char* StringStats::name(StringOperation operation) noexcept {
+    switch (operation) {
+    case StringOperation::Construct:
+        return "construct";
+    case StringOperation::Copy:
+        return "copy";
+    case StringOperation::Move:
+        return "move";
+    case StringOperation::Insert:
+        return "insert";
+    case StringOperation::Erase:
+        return "erase";
+    case StringOperation::Find:
+        return "find";
+    case StringOperation::Split:
+        return "split";
+    case StringOperation::Replace:
+        return "replace";
+    case StringOperation::Format:
+        return "format";
+    case StringOperation::Count:
+        break;
+    }
+    return "unknown";
+}
+
+String StringStats::to_text() const {
+    std::stringstream ss;
+    ss << std::left;
+    for (std::size_t i = 0; i < m_stats.size(); ++i) {
+        const auto& stats = m_stats[i];
+        ss << std::setw(10) << name(StringOperation(i))
+           << " calls=" << stats.calls
+           << " bytes_copied=" << stats.bytes_copied
+           << " allocations=" << stats.allocations
+           << " reallocations=" << stats.reallocations
+           << " ns=" << stats.nanoseconds << '\n';
+    }
+    String result;
+    ss >> result;
+    return result;
+}
+
+String StringStats::to_json() const {
+    std::stringstream ss;
+    ss << "{\"enabled\":" << (enabled() ? "true" : "false") << ",\"operations\":{";
+    for (std::size_t i = 0; i < m_stats.size(); ++i) {
+        const auto& stats = m_stats[i];
+        if (i != 0)
+            ss << ',';
+        ss << '"' << name(StringOperation(i)) << "\":{"
+           << "\"calls\":" << stats.calls
+           << ",\"bytes_copied\":" << stats.bytes_copied
+           << ",\"allocations\":" << stats.allocations
+           << ",\"reallocations\":" << stats.reallocations
+           << ",\"nanoseconds\":" << stats.nanoseconds << '}';
+    }
+    ss << "}}";
+    String result;
+    ss >> result;
+    return result;
+}
+
+#if defined(STRING_INSTRUMENT)
+
+detail::InstrumentScope::InstrumentScope(StringOperation operation, const std::vector<char>* chars) noexcept
+    : m_operation(operation)
+    , m_chars(chars)
+    , m_capacity_before(chars ? chars->capacity() : 0)
+    , m_start(0)
+    , m_parent(t_current_scope) {
+    t_current_scope = this;
+    if (!m_parent)
+        m_start = now_ns();
+}
+
+detail::InstrumentScope::~InstrumentScope() {
+    if (m_chars) {
+        const auto capacity_after = m_chars->capacity();
+        if (capacity_after != m_capacity_before) {
+            if (m_capacity_before == 0)
+                ++m_allocations;
+            else
+                ++m_reallocations;
+        }
+    }
+    t_current_scope = m_parent;
+    if (m_parent) {
+        // nested operations are part of the outer one
+        m_parent->m_bytes_copied += m_bytes_copied;
+        m_parent->m_allocations += m_allocations;
+        m_parent->m_reallocations += m_reallocations;
+        return;
+    }
+    auto& stats = t_stats.stats[std::size_t(m_operation)];
+    bump(stats.calls, 1);
+    bump(stats.bytes_copied, m_bytes_copied);
+    bump(stats.allocations, m_allocations);
+    bump(stats.reallocations, m_reallocations);
+    bump(stats.nanoseconds, now_ns() - m_start);
+}
+
+void detail::InstrumentScope::add(std::uint64_t bytes_copied, std::uint64_t allocations) noexcept {
+    if (t_current_scope) {
+        t_current_scope->m_bytes_copied += bytes_copied;
+        t_current_scope->m_allocations += allocations;
+    }
+}
+
+#endif
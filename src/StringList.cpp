@@ -0,0 +1,70 @@
+#include "StringList.h"
+
+#include <stdexcept>
+
+StringList::StringList(std::initializer_list<std::string_view> elements) {
+    std::size_t total = 0;
+    for (auto element : elements)
+        total += element.size();
+    reserve(elements.size(), total);
+    for (auto element : elements)
+        push_back(element);
+}
+
+StringList::StringList(const std::vector<String>& elements) {
+    std::size_t total = 0;
+    for (const auto& element : elements)
+        total += element.size();
+    reserve(elements.size(), total);
+    for (const auto& element : elements)
+        push_back(element);
+}
+
+std::string_view StringList::at(std::size_t i) const {
+    if (i >= size())
+        throw std::out_of_range("StringList index out of range");
+    return (*this)[i];
+}
+
+void StringList::push_back(std::string_view element) {
+    if (m_offsets.empty())
+        m_offsets.push_back(0);
+    const auto old_size = m_chars.size();
+    const auto* data    = m_chars.data();
+    if (element.data() >= data && element.data() < data + old_size) {
+        // a view into ourselves, which resizing would invalidate
+        const auto offset = static_cast<std::size_t>(element.data() - data);
+        m_chars.resize(old_size + element.size());
+        std::memcpy(m_chars.data() + old_size, m_chars.data() + offset, element.size());
+    } else {
+        m_chars.insert(m_chars.end(), element.begin(), element.end());
+    }
+    m_offsets.push_back(m_chars.size());
+}
+
+void StringList::pop_back() noexcept {
+    m_offsets.pop_back();
+    m_chars.resize(m_offsets.back());
+}
+
+void StringList::clear() noexcept {
+    m_chars.clear();
+    m_offsets.resize(1);
+}
+
+void StringList::reserve(std::size_t elements, std::size_t total_size) {
+    m_offsets.reserve(elements + 1);
+    m_chars.reserve(total_size);
+}
+
+std::vector<String> StringList::to_vector() const {
+    std::vector<String> result;
+    result.reserve(size());
+    for (auto element : *this)
+        result.push_back(String(element));
+    return result;
+}
+
+bool StringList::operator==(const StringList& other) const noexcept {
+    return size() == other.size() && m_chars == other.m_chars && (empty() || m_offsets == other.m_offsets);
+}
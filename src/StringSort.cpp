@@ -0,0 +1,148 @@
+// MSD radix sort for strings, after Kärkkäinen and Rantala, "Engineering radix sort for strings"
+// (2008): the chars of a pass are cached in a contiguous array before counting and distributing,
+// and small buckets are handed to Bentley and Sedgewick's multikey quicksort (1997).
+
+#include "StringSort.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+using detail::SortKey;
+
+// buckets smaller than this are sorted by multikey quicksort, then insertion sort
+constexpr std::size_t quicksort_threshold = 64;
+constexpr std::size_t insertion_threshold = 16;
+
+// the char at `depth` as 1..256, or 0 if the key ends before it, so that shorter keys sort first
+inline unsigned bucket_of(const SortKey& key, std::size_t depth) {
+    return depth < key.size ? 1u + static_cast<unsigned char>(key.data[depth]) : 0u;
+}
+
+// whether `a` sorts before `b`, given that their first `depth` chars are equal
+inline bool less_from(const SortKey& a, const SortKey& b, std::size_t depth) {
+    const std::size_t common = std::min(a.size, b.size);
+    if (common > depth) {
+        const int result = std::memcmp(a.data + depth, b.data + depth, common - depth);
+        if (result != 0)
+            return result < 0;
+    }
+    return a.size < b.size;
+}
+
+void insertion_sort(SortKey* keys, std::size_t n, std::size_t depth) {
+    for (std::size_t i = 1; i < n; ++i) {
+        const SortKey key = keys[i];
+        std::size_t   j   = i;
+        for (; j > 0 && less_from(key, keys[j - 1], depth); --j)
+            keys[j] = keys[j - 1];
+        keys[j] = key;
+    }
+}
+
+void multikey_quicksort(SortKey* keys, std::size_t n, std::size_t depth) {
+    while (n > insertion_threshold) {
+        // median of three as the pivot char
+        unsigned a = bucket_of(keys[0], depth);
+        unsigned b = bucket_of(keys[n / 2], depth);
+        unsigned c = bucket_of(keys[n - 1], depth);
+        if (a > b)
+            std::swap(a, b);
+        const unsigned pivot = c < a ? a : c > b ? b : c;
+
+        // partition into [0, lt) below, [lt, gt) equal to and [gt, n) above the pivot
+        std::size_t lt = 0;
+        std::size_t gt = n;
+        for (std::size_t i = 0; i < gt;) {
+            const unsigned bucket = bucket_of(keys[i], depth);
+            if (bucket < pivot)
+                std::swap(keys[lt++], keys[i++]);
+            else if (bucket > pivot)
+                std::swap(keys[i], keys[--gt]);
+            else
+                ++i;
+        }
+        // both sides are smaller than n, so this recurses at most n deep
+        multikey_quicksort(keys, lt, depth);
+        multikey_quicksort(keys + gt, n - gt, depth);
+        if (pivot == 0)
+            return; // all keys equal to the pivot ended, so they are equal
+        keys += lt;
+        n = gt - lt;
+        ++depth;
+    }
+    insertion_sort(keys, n, depth);
+}
+
+struct Bucket {
+    std::size_t begin;
+    std::size_t size;
+    std::size_t depth;
+};
+
+}
+
+void detail::sort_keys(SortKey* keys, std::size_t n) {
+    if (n < quicksort_threshold) {
+        multikey_quicksort(keys, n, 0);
+        return;
+    }
+    std::vector<SortKey>       buffer(n);
+    std::vector<std::uint16_t> cache(n);
+    // buckets still to be sorted, depth first, so there are at most 256 per level of depth
+    std::vector<Bucket>        pending { Bucket { 0, n, 0 } };
+    while (!pending.empty()) {
+        const Bucket bucket = pending.back();
+        pending.pop_back();
+        SortKey* const first = keys + bucket.begin;
+        if (bucket.size < quicksort_threshold) {
+            multikey_quicksort(first, bucket.size, bucket.depth);
+            continue;
+        }
+
+        std::size_t counts[257] = {};
+        for (std::size_t i = 0; i < bucket.size; ++i) {
+            cache[i] = static_cast<std::uint16_t>(bucket_of(first[i], bucket.depth));
+            ++counts[cache[i]];
+        }
+        // a common char needs no distribution, only a look at the next one
+        if (counts[cache[0]] == bucket.size) {
+            if (cache[0] != 0)
+                pending.push_back(Bucket { bucket.begin, bucket.size, bucket.depth + 1 });
+            continue;
+        }
+
+        std::size_t starts[257];
+        std::size_t start = 0;
+        for (std::size_t b = 0; b < 257; ++b) {
+            starts[b] = start;
+            start += counts[b];
+        }
+        for (std::size_t i = 0; i < bucket.size; ++i)
+            buffer[starts[cache[i]]++] = first[i];
+        std::copy(buffer.begin(), buffer.begin() + std::ptrdiff_t(bucket.size), first);
+
+        // bucket 0 holds the keys which ended, which are all equal
+        std::size_t offset = bucket.begin + counts[0];
+        for (std::size_t b = 1; b < 257; ++b) {
+            if (counts[b] > 1)
+                pending.push_back(Bucket { offset, counts[b], bucket.depth + 1 });
+            offset += counts[b];
+        }
+    }
+}
+
+void sort_strings(StringList& strings) {
+    std::vector<detail::SortKey> keys;
+    keys.reserve(strings.size());
+    for (std::size_t i = 0; i < strings.size(); ++i)
+        keys.push_back(detail::SortKey { strings[i].data(), strings[i].size(), i });
+    detail::sort_keys(keys.data(), keys.size());
+    StringList sorted;
+    sorted.reserve(strings.size(), strings.total_size());
+    for (const auto& key : keys)
+        sorted.push_back(std::string_view(key.data, key.size));
+    strings = std::move(sorted);
+}
@@ -0,0 +1,352 @@
+#include "SubstringIndex.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+
+// Suffix array of the `n` symbols in `s`, which lie in [0, upper], by SA-IS. Follows the
+// formulation of the AtCoder Library, which needs no sentinel at the end of the input.
+template<class Symbols>
+std::vector<int> sa_is(const Symbols& s, int n, int upper) {
+    if (n == 0)
+        return {};
+    if (n == 1)
+        return { 0 };
+    if (n == 2)
+        return s[0] < s[1] ? std::vector<int> { 0, 1 } : std::vector<int> { 1, 0 };
+
+    // a suffix is S-type if it sorts before the one behind it, and L-type otherwise
+    std::vector<int>  sa(std::size_t(n), 0);
+    std::vector<bool> is_s(static_cast<std::size_t>(n));
+    for (int i = n - 2; i >= 0; --i)
+        is_s[i] = s[i] == s[i + 1] ? is_s[i + 1] : s[i] < s[i + 1];
+
+    // each symbol's bucket holds its L-type suffixes first, then its S-type ones
+    std::vector<int> start_l(std::size_t(upper) + 1), start_s(std::size_t(upper) + 1);
+    for (int i = 0; i < n; ++i) {
+        if (!is_s[i])
+            ++start_s[s[i]];
+        else
+            ++start_l[s[i] + 1];
+    }
+    for (int c = 0; c <= upper; ++c) {
+        start_s[c] += start_l[c];
+        if (c < upper)
+            start_l[c + 1] += start_s[c];
+    }
+
+    // sorts all suffixes from the given order of the LMS suffixes, by placing those and inducing
+    // the L-type suffixes from front to back and then the S-type ones from back to front
+    auto induce = [&](const std::vector<int>& lms) {
+        std::fill(sa.begin(), sa.end(), -1);
+        std::vector<int> next(start_s);
+        for (int d : lms)
+            if (d != n)
+                sa[next[s[d]]++] = d;
+        next = start_l;
+        sa[next[s[n - 1]]++] = n - 1;
+        for (int i = 0; i < n; ++i) {
+            const int v = sa[i];
+            if (v >= 1 && !is_s[v - 1])
+                sa[next[s[v - 1]]++] = v - 1;
+        }
+        next = start_l;
+        for (int i = n - 1; i >= 0; --i) {
+            const int v = sa[i];
+            if (v >= 1 && is_s[v - 1])
+                sa[--next[s[v - 1] + 1]] = v - 1;
+        }
+    };
+
+    // LMS (leftmost S-type) positions, and their numbers in text order
+    std::vector<int> lms_number(std::size_t(n) + 1, -1);
+    std::vector<int> lms;
+    for (int i = 1; i < n; ++i) {
+        if (!is_s[i - 1] && is_s[i]) {
+            lms_number[i] = int(lms.size());
+            lms.push_back(i);
+        }
+    }
+    const int m = int(lms.size());
+
+    induce(lms);
+
+    if (m != 0) {
+        // induced sorting orders the LMS substrings correctly, so naming equal ones alike gives a
+        // reduced problem whose suffix array is the order of the LMS suffixes
+        std::vector<int> sorted_lms;
+        sorted_lms.reserve(std::size_t(m));
+        for (int v : sa)
+            if (lms_number[v] != -1)
+                sorted_lms.push_back(v);
+        std::vector<int> reduced(static_cast<std::size_t>(m));
+        int              names = 0;
+        reduced[lms_number[sorted_lms[0]]] = 0;
+        for (int i = 1; i < m; ++i) {
+            int       l     = sorted_lms[i - 1];
+            int       r     = sorted_lms[i];
+            const int end_l = lms_number[l] + 1 < m ? lms[lms_number[l] + 1] : n;
+            const int end_r = lms_number[r] + 1 < m ? lms[lms_number[r] + 1] : n;
+            bool      same  = true;
+            if (end_l - l != end_r - r) {
+                same = false;
+            } else {
+                while (l < end_l && s[l] == s[r]) {
+                    ++l;
+                    ++r;
+                }
+                if (l == n || s[l] != s[r])
+                    same = false;
+            }
+            if (!same)
+                ++names;
+            reduced[lms_number[sorted_lms[i]]] = names;
+        }
+        const auto reduced_sa = sa_is(reduced, m, names);
+        for (int i = 0; i < m; ++i)
+            sorted_lms[i] = lms[reduced_sa[i]];
+        induce(sorted_lms);
+    }
+    return sa;
+}
+
+// hash of all of `text`, eight chars at a time, to recognize the text an index file was built for
+std::uint64_t hash_text(std::string_view text) {
+    constexpr std::uint64_t multiplier = 0xff51afd7ed558ccdull;
+    std::uint64_t           hash       = 0x9e3779b97f4a7c15ull ^ text.size();
+    const char*             p          = text.data();
+    std::size_t             n          = text.size();
+    for (; n >= 8; p += 8, n -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, p, 8);
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 29;
+    }
+    if (n != 0) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, p, n);
+        hash = (hash ^ word) * multiplier;
+        hash ^= hash >> 29;
+    }
+    return hash;
+}
+
+// an index file is this header, followed by the suffix array and the LCP array
+struct FileHeader {
+    char          magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t text_size;
+    std::uint64_t text_hash;
+};
+
+constexpr char          file_magic[8] = { 'S', 'U', 'F', 'F', 'I', 'X', 'I', 'X' };
+constexpr std::uint32_t file_version  = 1;
+
+// length of the common prefix of `a` and `b`
+std::size_t common_prefix(std::string_view a, std::string_view b) noexcept {
+    const auto n = std::min(a.size(), b.size());
+    return std::size_t(std::mismatch(a.begin(), a.begin() + n, b.begin()).first - a.begin());
+}
+
+}
+
+SubstringIndex::SubstringIndex(std::string_view text)
+    : m_text(text) {
+    if (text.size() > max_size)
+        throw std::length_error("text too long for a SubstringIndex");
+    const int n  = int(text.size());
+    auto      sa = sa_is(reinterpret_cast<const unsigned char*>(text.data()), n, 255);
+    m_storage.resize(2 * text.size());
+    std::copy(sa.begin(), sa.end(), m_storage.begin());
+    m_suffixes = m_storage.data();
+    m_lcp      = m_storage.data() + n;
+
+    // Kasai et al.: going through the suffixes in text order, the common prefix with the previous
+    // suffix in sorted order shrinks by at most one char from one to the next
+    auto& rank = sa;
+    for (int i = 0; i < n; ++i)
+        rank[m_storage[i]] = i;
+    std::uint32_t* lcp    = m_storage.data() + n;
+    std::size_t    common = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        if (rank[i] == 0) {
+            lcp[0] = 0;
+            common = 0;
+            continue;
+        }
+        const std::size_t j = m_suffixes[rank[i] - 1];
+        while (i + common < text.size() && j + common < text.size() && text[i + common] == text[j + common])
+            ++common;
+        lcp[rank[i]] = std::uint32_t(common);
+        if (common != 0)
+            --common;
+    }
+}
+
+SubstringIndex::SubstringIndex(SubstringIndex&& other) noexcept
+    : m_text(std::exchange(other.m_text, std::string_view()))
+    , m_storage(std::move(other.m_storage))
+    , m_file(std::move(other.m_file))
+    , m_suffixes(std::exchange(other.m_suffixes, nullptr))
+    , m_lcp(std::exchange(other.m_lcp, nullptr)) {
+}
+
+SubstringIndex& SubstringIndex::operator=(SubstringIndex&& other) noexcept {
+    if (this != &other) {
+        m_text     = std::exchange(other.m_text, std::string_view());
+        m_storage  = std::move(other.m_storage);
+        m_file     = std::move(other.m_file);
+        m_suffixes = std::exchange(other.m_suffixes, nullptr);
+        m_lcp      = std::exchange(other.m_lcp, nullptr);
+        other.m_storage.clear();
+    }
+    return *this;
+}
+
+void SubstringIndex::save(const char* path) const {
+    FileHeader header {};
+    std::memcpy(header.magic, file_magic, sizeof file_magic);
+    header.version   = file_version;
+    header.text_size = m_text.size();
+    header.text_hash = hash_text(m_text);
+    const std::size_t                   array_size = m_text.size() * sizeof(std::uint32_t);
+    const std::vector<std::string_view> pieces {
+        std::string_view(reinterpret_cast<const char*>(&header), sizeof header),
+        std::string_view(reinterpret_cast<const char*>(m_suffixes), array_size),
+        std::string_view(reinterpret_cast<const char*>(m_lcp), array_size),
+    };
+
+    const int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        throw std::system_error(errno, std::generic_category(), std::string("open ") + path);
+    try {
+        write_all(fd, pieces);
+    } catch (...) {
+        ::close(fd);
+        throw;
+    }
+    if (::close(fd) != 0)
+        throw std::system_error(errno, std::generic_category(), "close");
+}
+
+SubstringIndex SubstringIndex::load(const char* path, std::string_view text) {
+    MappedFile file(path);
+    FileHeader header;
+    if (file.size() < sizeof header)
+        throw std::runtime_error(std::string(path) + " is not a substring index");
+    std::memcpy(&header, file.data(), sizeof header);
+    const auto arrays = file.size() - sizeof header;
+    if (std::memcmp(header.magic, file_magic, sizeof file_magic) != 0 || header.version != file_version
+        || arrays % (2 * sizeof(std::uint32_t)) != 0 || arrays / (2 * sizeof(std::uint32_t)) != header.text_size)
+        throw std::runtime_error(std::string(path) + " is not a substring index");
+    if (header.text_size != text.size() || header.text_hash != hash_text(text))
+        throw std::runtime_error(std::string(path) + " was built for another text");
+    // the queries trust the arrays, so a damaged file must not get past here
+    const auto* suffixes = reinterpret_cast<const std::uint32_t*>(file.data() + sizeof header);
+    const auto* lcp      = suffixes + text.size();
+    for (std::size_t rank = 0; rank < text.size(); ++rank)
+        if (suffixes[rank] >= text.size() || lcp[rank] > text.size() - suffixes[rank])
+            throw std::runtime_error(std::string(path) + " is not a substring index");
+
+    SubstringIndex index;
+    index.m_text     = text;
+    // the mapping is page aligned, so the arrays behind the header are aligned as well
+    index.m_suffixes = suffixes;
+    index.m_lcp      = lcp;
+    index.m_file     = std::move(file);
+    return index;
+}
+
+std::size_t SubstringIndex::lower_bound(std::string_view pattern) const noexcept {
+    // the first rank whose suffix does not sort before `pattern`. All suffixes between the bounds
+    // share at least as many chars with `pattern` as both bounds do, so those are not compared again.
+    std::size_t left = 0, right = size(), left_match = 0, right_match = 0;
+    while (left < right) {
+        const auto  mid     = left + (right - left) / 2;
+        const auto  suffix  = m_text.substr(m_suffixes[mid]);
+        std::size_t matched = std::min(left_match, right_match);
+        matched += common_prefix(suffix.substr(matched), pattern.substr(matched));
+        const bool before = matched < pattern.size()
+            && (matched == suffix.size() || static_cast<unsigned char>(suffix[matched]) < static_cast<unsigned char>(pattern[matched]));
+        if (before) {
+            left       = mid + 1;
+            left_match = matched;
+        } else {
+            right       = mid;
+            right_match = matched;
+        }
+    }
+    return left;
+}
+
+std::size_t SubstringIndex::upper_bound(std::string_view pattern) const noexcept {
+    // the first rank whose suffix sorts after `pattern` and does not start with it
+    std::size_t left = 0, right = size(), left_match = 0, right_match = 0;
+    while (left < right) {
+        const auto  mid     = left + (right - left) / 2;
+        const auto  suffix  = m_text.substr(m_suffixes[mid]);
+        std::size_t matched = std::min(left_match, right_match);
+        matched += common_prefix(suffix.substr(matched), pattern.substr(matched));
+        const bool not_after = matched == pattern.size() || matched == suffix.size()
+            || static_cast<unsigned char>(suffix[matched]) < static_cast<unsigned char>(pattern[matched]);
+        if (not_after) {
+            left       = mid + 1;
+            left_match = matched;
+        } else {
+            right       = mid;
+            right_match = matched;
+        }
+    }
+    return left;
+}
+
+bool SubstringIndex::contains(std::string_view pattern) const noexcept {
+    if (pattern.empty())
+        return true;
+    const auto rank = lower_bound(pattern);
+    return rank < size() && m_text.substr(m_suffixes[rank], pattern.size()) == pattern;
+}
+
+std::size_t SubstringIndex::count(std::string_view pattern) const noexcept {
+    if (pattern.empty())
+        return size() + 1;
+    return upper_bound(pattern) - lower_bound(pattern);
+}
+
+std::vector<std::size_t> SubstringIndex::find_all(std::string_view pattern) const {
+    std::vector<std::size_t> offsets;
+    if (pattern.empty()) {
+        offsets.resize(size() + 1);
+        for (std::size_t i = 0; i <= size(); ++i)
+            offsets[i] = i;
+        return offsets;
+    }
+    const auto first = lower_bound(pattern);
+    if (first == size() || m_text.substr(m_suffixes[first], pattern.size()) != pattern)
+        return offsets;
+    // the suffixes behind the first match match as well as long as they share the whole pattern
+    // with the one before, which the LCP array tells without comparing
+    auto last = first + 1;
+    while (last < size() && m_lcp[last] >= pattern.size())
+        ++last;
+    offsets.assign(m_suffixes + first, m_suffixes + last);
+    std::sort(offsets.begin(), offsets.end());
+    return offsets;
+}
+
+std::string_view SubstringIndex::longest_repeat() const noexcept {
+    std::size_t best = 0;
+    for (std::size_t rank = 1; rank < size(); ++rank)
+        if (m_lcp[rank] > m_lcp[best])
+            best = rank;
+    return size() == 0 ? std::string_view() : m_text.substr(m_suffixes[best], m_lcp[best]);
+}
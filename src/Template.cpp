@@ -0,0 +1,62 @@
+#include "Template.h"
+
+Template::Template(const String& source)
+    : Template(source.view()) {
+}
+
+Template::Template(const char* source)
+    : Template(std::string_view(source)) {
+}
+
+Template::Template(std::string_view source)
+    : m_source(source) {
+    compile();
+}
+
+void Template::compile() {
+    const auto  p = m_source.view();
+    std::size_t i = 0;
+    // literal chars pending since the last slot, merged into one segment
+    std::size_t literal_start = 0;
+    auto        flush_literal = [&] {
+        if (m_literals.size() != literal_start)
+            m_segments.push_back(Segment { literal, literal_start, m_literals.size() - literal_start });
+        literal_start = m_literals.size();
+    };
+    while (i < p.size()) {
+        const auto dollar = p.find('$', i);
+        const auto end    = dollar == std::string_view::npos ? p.size() : dollar;
+        m_literals += String(p.substr(i, end - i));
+        if (dollar == std::string_view::npos || dollar + 1 == p.size()) {
+            if (dollar != std::string_view::npos)
+                m_literals += String('$');
+            break;
+        }
+        if (p[dollar + 1] == '$') {
+            m_literals += String('$');
+            i = dollar + 2;
+            continue;
+        }
+        if (p[dollar + 1] != '{') {
+            m_literals += String('$');
+            i = dollar + 1;
+            continue;
+        }
+        const auto name_start = dollar + 2;
+        const auto close      = p.find('}', name_start);
+        if (close == std::string_view::npos)
+            throw std::invalid_argument("unterminated '${' in template");
+        if (close == name_start)
+            throw std::invalid_argument("empty slot name in template");
+        const auto  name = p.substr(name_start, close - name_start);
+        std::size_t slot = 0;
+        while (slot < m_slots.size() && slot_name(slot) != name)
+            ++slot;
+        if (slot == m_slots.size())
+            m_slots.push_back(Name { name_start, name.size() });
+        flush_literal();
+        m_segments.push_back(Segment { slot, 0, 0 });
+        i = close + 1;
+    }
+    flush_literal();
+}
@@ -0,0 +1 @@
+/usr/include/catch2/catch.hpp
\ No newline at end of file
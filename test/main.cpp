@@ -2,6 +2,21 @@
 #include <iomanip>
 #include <iostream>
 #include "../include/String.h"
+#include "../include/Csv.h"
+#include "../include/Glob.h"
+#include "../include/StringList.h"
+#include "../include/StringIO.h"
+#include "../include/Template.h"
+#include "../include/StringSort.h"
+#include "../include/LineIndex.h"
+#include "../include/GapString.h"
+#include "../include/ReplaceFilter.h"
+#include "../include/SubstringIndex.h"
+#include <thread>
+#include <fstream>
+#include <map>
+#include <set>
+#include <unistd.h>
 
 //*
 
@@ -242,6 +257,9 @@ TEST_CASE("String::clear, not empty") {
     REQUIRE(s.size() == 12);
     s.clear();
     REQUIRE(s.size() == 0);
+    REQUIRE(s.capacity() >= 12);
+    REQUIRE(s.data()[0] == '\0');
+    REQUIRE(std::string(s.c_str()).empty());
 }
 
 TEST_CASE("String::erase iter") {
@@ -499,3 +517,1557 @@ TEST_CASE("String::shrink_to_fit") {
 }
 
 //*/
+
+TEST_CASE("String::view") {
+    String s("Hello, World");
+    REQUIRE(s.view() == "Hello, World");
+    REQUIRE(s.view().data() == s.data());
+    std::string_view v = s;
+    REQUIRE(v == "Hello, World");
+    REQUIRE(String(v.substr(7)) == "World");
+}
+
+static std::vector<std::vector<std::string>> read_all(CsvReader& reader) {
+    std::vector<std::vector<std::string>> result;
+    CsvRecord                             record;
+    while (reader.next(record)) {
+        result.emplace_back();
+        for (auto field : record)
+            result.back().emplace_back(field);
+    }
+    return result;
+}
+
+TEST_CASE("CsvReader") {
+    using Rows = std::vector<std::vector<std::string>>;
+    {
+        // plain, views into the input
+        String    s("a,b,c\n1,2,3\n");
+        CsvReader reader(s);
+        CsvRecord record;
+        REQUIRE(reader.next(record));
+        REQUIRE(record.size() == 3);
+        REQUIRE(record[0] == "a");
+        REQUIRE(record[2].data() == s.data() + 4);
+        REQUIRE(reader.next(record));
+        REQUIRE(record.to_strings() == std::vector<String> { "1", "2", "3" });
+        REQUIRE_FALSE(reader.next(record));
+        REQUIRE(reader.records() == 2);
+    }
+    {
+        // quotes, doubled quotes, embedded newlines, CRLF, empty fields
+        String    s("\"x, y\",\"say \"\"hi\"\"\",\"multi\nline\"\r\n,,\r\nlast");
+        CsvReader reader(s);
+        REQUIRE(read_all(reader) == Rows { { "x, y", "say \"hi\"", "multi\nline" }, { "", "", "" }, { "last" } });
+    }
+    {
+        // empty lines
+        String    s("a\n\n\nb\n");
+        CsvReader reader(s);
+        REQUIRE(read_all(reader) == Rows { { "a" }, { "b" } });
+        CsvDialect dialect       = CsvDialect::csv();
+        dialect.skip_empty_lines = false;
+        CsvReader reader2(s, dialect);
+        REQUIRE(read_all(reader2) == Rows { { "a" }, { "" }, { "" }, { "b" } });
+    }
+    {
+        // tsv and escapes
+        CsvDialect dialect = CsvDialect::tsv();
+        dialect.escape     = '\\';
+        String    s("a\\\tb\t\"c\"\td\\\\\n");
+        CsvReader reader(s, dialect);
+        REQUIRE(read_all(reader) == Rows { { "a\tb", "\"c\"", "d\\" } });
+    }
+    {
+        // errors
+        String    s1("\"unterminated");
+        CsvReader reader1(s1);
+        CsvRecord record;
+        REQUIRE_THROWS(reader1.next(record));
+        String    s2("\"a\"b,c");
+        CsvReader reader2(s2);
+        REQUIRE_THROWS(reader2.next(record));
+    }
+    {
+        // streams, with records spanning chunk boundaries
+        std::string text;
+        for (int i = 0; i < 100; ++i)
+            text += std::to_string(i) + ",\"quoted \"\"" + std::to_string(i) + "\"\"\",plain field\r\n";
+        for (std::size_t chunk_size : { 1, 2, 3, 7, 64, 4096 }) {
+            std::istringstream stream(text);
+            CsvReader          reader(stream, CsvDialect::csv(), chunk_size);
+            auto               rows = read_all(reader);
+            REQUIRE(rows.size() == 100);
+            REQUIRE(rows[42] == std::vector<std::string> { "42", "quoted \"42\"", "plain field" });
+        }
+    }
+    {
+        // a record far larger than a chunk is read with a logarithmic amount of refills, not one
+        // per chunk, as it is parsed again from its start after each
+        struct CountingBuffer : std::stringbuf {
+            std::size_t reads { 0 };
+            using std::stringbuf::stringbuf;
+            std::streamsize xsgetn(char* s, std::streamsize n) override {
+                ++reads;
+                return std::stringbuf::xsgetn(s, n);
+            }
+        };
+        const std::string long_field(1 << 20, 'x');
+        CountingBuffer    buffer("a,\"" + long_field + "\",b\nc,d,e\n");
+        std::istream      stream(&buffer);
+        CsvReader         reader(stream, CsvDialect::csv(), 16);
+        auto              rows = read_all(reader);
+        REQUIRE(rows.size() == 2);
+        REQUIRE(rows[0][1] == long_field);
+        REQUIRE(buffer.reads < 64);
+    }
+}
+
+TEST_CASE("String::to_lower and String::to_upper") {
+    String s("Hello, World! 0123456789 @[`{ ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz \xC4\xE4");
+    s.to_lower();
+    REQUIRE(s == "hello, world! 0123456789 @[`{ abcdefghijklmnopqrstuvwxyz abcdefghijklmnopqrstuvwxyz \xC4\xE4");
+    s.to_upper();
+    REQUIRE(s == "HELLO, WORLD! 0123456789 @[`{ ABCDEFGHIJKLMNOPQRSTUVWXYZ ABCDEFGHIJKLMNOPQRSTUVWXYZ \xC4\xE4");
+
+    String empty;
+    empty.to_lower();
+    REQUIRE(empty.empty());
+}
+
+TEST_CASE("String::trim, ltrim, rtrim") {
+    String s1(" \t\r\n Hello, World \v\f ");
+    s1.trim();
+    REQUIRE(s1 == "Hello, World");
+
+    String s2("  Hello  ");
+    s2.ltrim();
+    REQUIRE(s2 == "Hello  ");
+    s2.rtrim();
+    REQUIRE(s2 == "Hello");
+
+    String s3("   ");
+    s3.trim();
+    REQUIRE(s3.empty());
+
+    String s4("  x  ");
+    REQUIRE(s4.trim_view() == "x");
+    REQUIRE(s4.ltrim_view() == "x  ");
+    REQUIRE(s4.rtrim_view() == "  x");
+    REQUIRE(s4.trim_view().data() == s4.data() + 2);
+}
+
+TEST_CASE("String::strip") {
+    String s("--==Hello=--");
+    REQUIRE(s.strip_view("-=") == "Hello");
+    s.strip("-");
+    REQUIRE(s == "==Hello=");
+    s.strip("=");
+    REQUIRE(s == "Hello");
+    s.strip("");
+    REQUIRE(s == "Hello");
+    s.strip("Hoel");
+    REQUIRE(s.empty());
+}
+
+TEST_CASE("String::collapse_whitespace") {
+    String s1("  a \t\n b  ");
+    s1.collapse_whitespace();
+    REQUIRE(s1 == " a b ");
+    s1.trim();
+    REQUIRE(s1 == "a b");
+
+    String s2("a_rather_long_word_without_spaces    followed_by_another_rather_long_word\t\t\tend");
+    s2.collapse_whitespace();
+    REQUIRE(s2 == "a_rather_long_word_without_spaces followed_by_another_rather_long_word end");
+
+    String s3;
+    s3.collapse_whitespace();
+    REQUIRE(s3.empty());
+}
+
+TEST_CASE("String::join") {
+    std::vector<String> parts { "a", "b", "c" };
+    REQUIRE(String::join(", ", parts) == "a, b, c");
+    REQUIRE(String::join("", parts) == "abc");
+    REQUIRE(String::join(", ", std::vector<String> {}) == "");
+    REQUIRE(String::join(", ", std::vector<String> { "single" }) == "single");
+    REQUIRE(String::join("/", { "usr", "local", "bin" }) == "usr/local/bin");
+
+    std::vector<const char*> cstrs { "x", "y", "" };
+    REQUIRE(String::join("-", cstrs) == "x-y-");
+    std::vector<std::string_view> views { "one", "two" };
+    REQUIRE(String::join(" ", views) == "one two");
+    std::vector<std::string> std_strings { "std", "string" };
+    REQUIRE(String::join("::", std_strings) == "std::string");
+    std::vector<ConstString> const_strings { "const", "string" };
+    REQUIRE(String::join("_", const_strings) == "const_string");
+
+    // inverse of split
+    String s("a,b,,c");
+    REQUIRE(String::join(",", s.split(',')) == s);
+
+    // projection
+    struct Person {
+        String name;
+        int    age;
+    };
+    std::vector<Person> people { { "Alice", 30 }, { "Bob", 40 } };
+    REQUIRE(String::join(", ", people, [](const Person& p) { return p.name.view(); }) == "Alice, Bob");
+}
+
+TEST_CASE("String::join_to") {
+    String out("list: ");
+    String::join_to(out, ", ", std::vector<String> { "a", "b" });
+    REQUIRE(out == "list: a, b");
+    // grows exactly once, to the exact size needed
+    String exact;
+    String::join_to(exact, "--", std::vector<String> { "abc", "def", "ghi" });
+    REQUIRE(exact == "abc--def--ghi");
+    REQUIRE(exact.capacity() == exact.size());
+    // `out` itself as the separator, and pieces viewing into it
+    String self("-");
+    String::join_to(self, self, std::vector<String> { "a", "b", "c" });
+    REQUIRE(self == "-a-b-c");
+    String pieces("xy");
+    String::join_to(pieces, ",", std::vector<std::string_view> { pieces.view(), pieces.view().substr(1) });
+    REQUIRE(pieces == "xyxy,y");
+}
+
+TEST_CASE("StringStats") {
+    StringStats::reset();
+    String s("Hello, World");
+    s.insert(s.end(), "!");
+    auto parts = s.split(',');
+    auto stats = StringStats::snapshot();
+    if (!StringStats::enabled()) {
+        REQUIRE(stats[StringOperation::Construct].calls == 0);
+        REQUIRE(stats[StringOperation::Split].calls == 0);
+        REQUIRE(stats.to_json().startswith("{\"enabled\":false"));
+        return;
+    }
+    REQUIRE(stats[StringOperation::Construct].bytes_copied >= 12);
+    REQUIRE(stats[StringOperation::Construct].allocations >= 1);
+    REQUIRE(stats[StringOperation::Insert].calls == 1);
+    REQUIRE(stats[StringOperation::Insert].reallocations == 1);
+    REQUIRE(stats[StringOperation::Split].calls == 1);
+    // the two parts and the vector, the constructions are attributed to split
+    REQUIRE(stats[StringOperation::Split].allocations == 3);
+    REQUIRE(stats.to_json().startswith("{\"enabled\":true"));
+    REQUIRE(stats.to_text().contains("split"));
+
+    // other threads are aggregated, even after they exit
+    const auto constructs = StringStats::snapshot()[StringOperation::Construct].calls;
+    std::thread([] { String copy(String("abc")); }).join();
+    REQUIRE(StringStats::snapshot()[StringOperation::Construct].calls == constructs + 1);
+
+    // an invalid iterator throws before anything is recorded as copied
+    const auto inserted = StringStats::snapshot()[StringOperation::Insert].bytes_copied;
+    REQUIRE_THROWS(s.insert(s.end() + 1, 'x'));
+    REQUIRE(StringStats::snapshot()[StringOperation::Insert].bytes_copied == inserted);
+
+    StringStats::reset();
+    REQUIRE(StringStats::snapshot()[StringOperation::Split].calls == 0);
+}
+
+TEST_CASE("String::replace String, sizes and long inputs") {
+    String s1("aXbXXc");
+    s1.replace("X", "YY");
+    REQUIRE(s1 == "aYYbYYYYc");
+    s1.replace("YY", "");
+    REQUIRE(s1 == "abc");
+
+    // empty to_replace is a no-op
+    String s2("abc");
+    s2.replace("", "x");
+    REQUIRE(s2 == "abc");
+
+    // left to right, no overlaps, replaced text isn't searched again
+    String s3("aaaa");
+    s3.replace("aa", "b");
+    REQUIRE(s3 == "bb");
+    String s6("aab");
+    s6.replace("ab", "b");
+    REQUIRE(s6 == "ab");
+    String s7("aabab");
+    s7.replace("ab", "b", 1);
+    REQUIRE(s7 == "abab");
+
+    // long enough for the vectorized search
+    String s4;
+    String expected;
+    for (int i = 0; i < 100; ++i) {
+        s4 += "some filler text needle";
+        expected += "some filler text pin";
+    }
+    String s5 = s4;
+    s4.replace("needle", "pin");
+    REQUIRE(s4 == expected);
+    s5.replace("needle", "pin", 1);
+    REQUIRE(s5.startswith("some filler text pinsome filler text needle"));
+}
+
+TEST_CASE("GlobPattern") {
+    REQUIRE(GlobPattern("*.log").matches("access.log"));
+    REQUIRE(GlobPattern("*.log").matches(".log"));
+    REQUIRE_FALSE(GlobPattern("*.log").matches("access.log.1"));
+    REQUIRE_FALSE(GlobPattern("*.log").matches("nginx/access.log"));
+    REQUIRE(GlobPattern("exact").matches("exact"));
+    REQUIRE_FALSE(GlobPattern("exact").matches("exac"));
+    REQUIRE(GlobPattern("").matches(""));
+    REQUIRE(GlobPattern("*").matches(""));
+
+    GlobPattern route("api/*/v?/users");
+    REQUIRE(route.matches("api/shop/v2/users"));
+    REQUIRE(route.matches("api//v1/users"));
+    REQUIRE_FALSE(route.matches("api/shop/v10/users"));
+    REQUIRE_FALSE(route.matches("api/a/b/v2/users"));
+    REQUIRE(route.pattern() == "api/*/v?/users");
+
+    // sets
+    REQUIRE(GlobPattern("file[0-9].txt").matches("file7.txt"));
+    REQUIRE_FALSE(GlobPattern("file[0-9].txt").matches("fileX.txt"));
+    REQUIRE(GlobPattern("file[!0-9].txt").matches("fileX.txt"));
+    REQUIRE(GlobPattern("[]a]").matches("]"));
+    REQUIRE_FALSE(GlobPattern("a[!x]b").matches("a/b"));
+
+    // double star
+    GlobPattern logs("/var/log/**/*.log");
+    REQUIRE(logs.matches("/var/log/nginx/access.log"));
+    REQUIRE(logs.matches("/var/log/a/b/c/x.log"));
+    REQUIRE(logs.matches("/var/log/x.log"));
+    REQUIRE_FALSE(logs.matches("/var/log/x.txt"));
+    REQUIRE(GlobPattern("src/**").matches("src/a/b.cpp"));
+    REQUIRE(GlobPattern("**.cpp").matches("src/a/b.cpp"));
+    REQUIRE(GlobPattern("**/test").matches("test"));
+    REQUIRE(GlobPattern("a/**/b").matches("a/b"));
+    REQUIRE(GlobPattern("a/**/b").matches("a/x/y/b"));
+    REQUIRE_FALSE(GlobPattern("a/**/b").matches("a/xb"));
+    REQUIRE_FALSE(GlobPattern("**/b").matches("xb"));
+    const std::string long_dir(70, 'd');
+    GlobPattern       long_logs(("/" + long_dir + "/**/b").c_str());
+    REQUIRE(long_logs.matches(("/" + long_dir + "/b").c_str()));
+    REQUIRE(long_logs.matches(("/" + long_dir + "/x/y/b").c_str()));
+    REQUIRE_FALSE(long_logs.matches(("/" + long_dir + "/xb").c_str()));
+
+    // escapes
+    REQUIRE(GlobPattern("what\\?").matches("what?"));
+    REQUIRE_FALSE(GlobPattern("what\\?").matches("whats"));
+
+    // many stars don't blow up
+    String many_stars;
+    String text;
+    for (int i = 0; i < 40; ++i) {
+        many_stars += "a*";
+        text += "aaaaaaaaaa";
+    }
+    many_stars += "b";
+    REQUIRE_FALSE(GlobPattern(many_stars).matches(text));
+    REQUIRE(GlobPattern(many_stars).matches(text + "b"));
+
+    // longer than one word of states
+    String long_pattern;
+    String long_text;
+    for (int i = 0; i < 50; ++i) {
+        long_pattern += "x?*";
+        long_text += "xyzz";
+    }
+    REQUIRE(GlobPattern(long_pattern).matches(long_text));
+    REQUIRE_FALSE(GlobPattern(long_pattern).matches(long_text.substring(long_text.begin(), long_text.size() - 5)));
+
+    REQUIRE_THROWS_AS(GlobPattern("[abc"), std::invalid_argument);
+    REQUIRE_THROWS_AS(GlobPattern("abc\\"), std::invalid_argument);
+}
+
+TEST_CASE("GlobSet") {
+    GlobSet set(std::vector<String> { "api/users", "api/*/orders", "static/**", "api/*" });
+    REQUIRE(set.size() == 4);
+    REQUIRE(set.first_match("api/users") == 0);
+    REQUIRE(set.first_match("api/shop/orders") == 1);
+    REQUIRE(set.first_match("static/css/main.css") == 2);
+    REQUIRE(set.first_match("api/products") == 3);
+    REQUIRE(set.first_match("other") == GlobSet::npos);
+    REQUIRE(set.match_any("api/x"));
+    REQUIRE_FALSE(set.match_any("api/x/y"));
+    REQUIRE(set.all_matches("api/users") == std::vector<std::size_t> { 0, 3 });
+
+    std::vector<GlobPattern> patterns { GlobPattern("*.cpp"), GlobPattern("*.h") };
+    REQUIRE(GlobPattern::match_any(patterns, "String.h"));
+    REQUIRE_FALSE(GlobPattern::match_any(patterns, "String.txt"));
+}
+
+TEST_CASE("StringList") {
+    StringList list;
+    REQUIRE(list.empty());
+    REQUIRE(list.size() == 0);
+    list.push_back("hello");
+    list.push_back(String("world"));
+    list.push_back("");
+    REQUIRE(list.size() == 3);
+    REQUIRE(list[0] == "hello");
+    REQUIRE(list.at(1) == "world");
+    REQUIRE(list.back() == "");
+    REQUIRE(list.total_size() == 10);
+    REQUIRE_THROWS_AS(list.at(3), std::out_of_range);
+    // views are contiguous
+    REQUIRE(list[0].data() + 5 == list[1].data());
+
+    // push_back of a view into the list itself
+    list.push_back(list[0]);
+    REQUIRE(list[3] == "hello");
+
+    list.pop_back();
+    REQUIRE(list.size() == 3);
+    REQUIRE(list.total_size() == 10);
+
+    std::vector<std::string_view> seen(list.begin(), list.end());
+    REQUIRE(seen == std::vector<std::string_view> { "hello", "world", "" });
+    REQUIRE(list.end() - list.begin() == 3);
+    REQUIRE(list.to_vector() == std::vector<String> { "hello", "world", "" });
+    REQUIRE(list == StringList { "hello", "world", "" });
+    REQUIRE(list != StringList { "hello", "world" });
+    REQUIRE(StringList(std::vector<String> { "a", "b" }) == StringList { "a", "b" });
+
+    // moved from lists are empty, and usable again
+    StringList moved(std::move(list));
+    REQUIRE(moved.size() == 3);
+    REQUIRE(list.empty());
+    REQUIRE(list.size() == 0);
+    REQUIRE(list.begin() == list.end());
+    REQUIRE(list == StringList());
+    list.push_back("again");
+    REQUIRE(list == StringList { "again" });
+    StringList assigned;
+    assigned = std::move(moved);
+    REQUIRE(assigned.size() == 3);
+    REQUIRE(moved.empty());
+    REQUIRE(moved.size() == 0);
+    REQUIRE(moved.begin() == moved.end());
+
+    list.clear();
+    REQUIRE(list.empty());
+}
+
+TEST_CASE("String::split_into") {
+    StringList list;
+    String("a,b,,c").split_into(list, ',');
+    REQUIRE(list == StringList { "a", "b", "", "c" });
+    String("").split_into(list, ',');
+    REQUIRE(list == StringList { "" });
+    String(",").split_into(list, ',');
+    REQUIRE(list == StringList { "", "" });
+    String("a--b----c").split_into(list, "--");
+    REQUIRE(list == StringList { "a", "b", "", "c" });
+    REQUIRE_THROWS(String("abc").split_into(list, ""));
+
+    // same results as split
+    for (const char* input : { "x y z", " leading", "trailing ", "", "no_delims", "  " }) {
+        String s(input);
+        s.split_into(list, ' ');
+        REQUIRE(list.to_vector() == s.split(' '));
+    }
+}
+
+TEST_CASE("String hex encoding") {
+    REQUIRE(String("").to_hex() == "");
+    REQUIRE(String("Hi!\n").to_hex() == "4869210a");
+    REQUIRE(String::from_hex("4869210A") == "Hi!\n");
+    REQUIRE(String::is_hex("00ffAB"));
+    REQUIRE_FALSE(String::is_hex("abc"));
+    REQUIRE_FALSE(String::is_hex("0g"));
+    REQUIRE_THROWS_AS(String::from_hex("abc"), std::invalid_argument);
+
+    // the error names the position, and the output is left unchanged
+    String out("keep");
+    try {
+        String::from_hex("00112233445566778899aabbccddeeff00112233445566778899aabbccddeefz", out);
+        FAIL("expected std::invalid_argument");
+    } catch (const std::invalid_argument& e) {
+        REQUIRE(std::string(e.what()).find("63") != std::string::npos);
+    }
+    REQUIRE(out == "keep");
+
+    // every byte value, through both the vectorized and the scalar paths
+    String all;
+    for (int i = 0; i < 256; ++i)
+        all += String(static_cast<char>(i));
+    const String hex = all.to_hex();
+    REQUIRE(hex.size() == 512);
+    REQUIRE(hex.view().substr(0, 6) == "000102");
+    REQUIRE(hex.view().substr(506) == "fdfeff");
+    REQUIRE(String::from_hex(hex) == all);
+    String upper = hex;
+    upper.to_upper();
+    REQUIRE(String::from_hex(upper) == all);
+
+    // appending, also to itself
+    String s("ab");
+    s.to_hex(s);
+    REQUIRE(s == "ab6162");
+}
+
+TEST_CASE("String Base64 encoding") {
+    // RFC 4648 test vectors
+    const std::vector<std::pair<const char*, const char*>> vectors {
+        { "", "" }, { "f", "Zg==" }, { "fo", "Zm8=" }, { "foo", "Zm9v" },
+        { "foob", "Zm9vYg==" }, { "fooba", "Zm9vYmE=" }, { "foobar", "Zm9vYmFy" },
+    };
+    for (const auto& vector : vectors) {
+        REQUIRE(String(vector.first).to_base64() == vector.second);
+        REQUIRE(String::from_base64(vector.second) == vector.first);
+        REQUIRE(String::is_base64(vector.second));
+    }
+    REQUIRE(String("fo").to_base64(String::Base64Alphabet::Standard, false) == "Zm8");
+    REQUIRE(String::from_base64("Zm8") == "fo");
+
+    const String binary(std::string_view("\xfb\xff\xfe"));
+    REQUIRE(binary.to_base64() == "+//+");
+    REQUIRE(binary.to_base64(String::Base64Alphabet::Url) == "-__-");
+    REQUIRE(String::from_base64("-__-", String::Base64Alphabet::Url) == binary);
+    REQUIRE_FALSE(String::is_base64("-__-"));
+
+    REQUIRE_FALSE(String::is_base64("Z"));
+    REQUIRE_FALSE(String::is_base64("Zm=v"));
+    REQUIRE_FALSE(String::is_base64("Zm9v="));
+    REQUIRE_THROWS_AS(String::from_base64("Zm9v!A=="), std::invalid_argument);
+    String out("keep");
+    REQUIRE_THROWS_AS(String::from_base64("Zm9vYmFy Zm9v", out), std::invalid_argument);
+    REQUIRE(out == "keep");
+
+    // round trips over lengths crossing the vectorized block sizes
+    std::uint32_t seed = 12345;
+    for (std::size_t n = 0; n < 100; ++n) {
+        String data;
+        for (std::size_t i = 0; i < n; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            data += String(static_cast<char>(seed >> 24));
+        }
+        for (auto alphabet : { String::Base64Alphabet::Standard, String::Base64Alphabet::Url }) {
+            for (bool padding : { true, false }) {
+                const String encoded = data.to_base64(alphabet, padding);
+                REQUIRE(encoded.size() == (padding ? (n + 2) / 3 * 4 : (n * 4 + 2) / 3));
+                REQUIRE(String::is_base64(encoded, alphabet));
+                REQUIRE(String::from_base64(encoded, alphabet) == data);
+            }
+        }
+        REQUIRE(String::from_hex(data.to_hex()) == data);
+    }
+
+    // the vectorized blocks against the scalar tail, which encodes each 3 bytes alone
+    String data;
+    for (std::size_t i = 0; i < 300; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        data += String(static_cast<char>(seed >> 24));
+    }
+    for (auto alphabet : { String::Base64Alphabet::Standard, String::Base64Alphabet::Url }) {
+        String expected;
+        for (std::size_t i = 0; i < data.size(); i += 3)
+            String(data.view().substr(i, 3)).to_base64(expected, alphabet);
+        REQUIRE(data.to_base64(alphabet) == expected);
+    }
+
+    // invalid chars are reported at their exact position, also inside the vectorized blocks
+    const String encoded = data.to_base64();
+    for (std::size_t position : { std::size_t(0), std::size_t(15), std::size_t(16), std::size_t(37), encoded.size() - 1 }) {
+        String broken = encoded;
+        broken[position] = '*';
+        REQUIRE_FALSE(String::is_base64(broken));
+        try {
+            String::from_base64(broken);
+            FAIL("no exception thrown");
+        } catch (const std::invalid_argument& e) {
+            REQUIRE(std::string_view(e.what()).substr(std::string_view(e.what()).rfind(' ') + 1) == std::to_string(position));
+        }
+    }
+}
+
+TEST_CASE("String JSON escaping") {
+    REQUIRE(String("").escape_json() == "");
+    REQUIRE(String("plain text, nothing to do").escape_json() == "plain text, nothing to do");
+    REQUIRE(String("say \"hi\"\\\n").escape_json() == "say \\\"hi\\\"\\\\\\n");
+    REQUIRE(String(std::string_view("\b\f\r\t\x01\x1f\0", 7)).escape_json() == "\\b\\f\\r\\t\\u0001\\u001f\\u0000");
+    REQUIRE(String("caf\xc3\xa9 /").escape_json() == "caf\xc3\xa9 /");
+
+    // nothing to escape returns the input itself, even past the vectorized blocks
+    String           buffer("untouched");
+    const String     clean("a long string without anything that JSON would need escaped");
+    std::string_view view = String::escape_json(clean, buffer);
+    REQUIRE(view.data() == clean.data());
+    REQUIRE(buffer == "untouched");
+    const String dirty("a long string with a \"quote\" somewhere after the first block");
+    view = String::escape_json(dirty, buffer);
+    REQUIRE(view.data() == buffer.data());
+    REQUIRE(view == "a long string with a \\\"quote\\\" somewhere after the first block");
+
+    REQUIRE(String::unescape_json("say \\\"hi\\\"\\\\\\n\\/") == "say \"hi\"\\\n/");
+    REQUIRE(String::unescape_json("\\u00e9\\u20AC\\ud83d\\ude00") == "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80");
+    REQUIRE(String::unescape_json("\\u0000").size() == 1);
+    for (const char* invalid : { "\\", "\\x", "\\u12", "\\u12g4", "\\ud83d", "\\ud83d\\u0041", "\\ude00" })
+        REQUIRE_THROWS_AS(String::unescape_json(invalid), std::invalid_argument);
+    String out("keep");
+    REQUIRE_THROWS_AS(String::unescape_json("fine \\q", out), std::invalid_argument);
+    REQUIRE(out == "keep");
+
+    // every byte value round trips, at every offset relative to a block
+    String all;
+    for (int i = 0; i < 256; ++i)
+        all += String(static_cast<char>(i));
+    for (std::size_t offset = 0; offset < 20; ++offset) {
+        const String s = String(std::string(offset, 'x')) + all;
+        REQUIRE(String::unescape_json(s.escape_json()) == s);
+    }
+
+    // appending, also to itself
+    String s("a\"");
+    s.escape_json(s);
+    REQUIRE(s == "a\"a\\\"");
+}
+
+TEST_CASE("String HTML escaping") {
+    REQUIRE(String("<a href=\"x\">Tom & Jerry's</a>").escape_html()
+            == "&lt;a href=&quot;x&quot;&gt;Tom &amp; Jerry&#39;s&lt;/a&gt;");
+    String           buffer;
+    const String     clean("nothing to escape in here, not even past sixteen chars");
+    REQUIRE(String::escape_html(clean, buffer).data() == clean.data());
+    REQUIRE(String::escape_html("1 < 2", buffer) == "1 &lt; 2");
+
+    REQUIRE(String::unescape_html("&lt;b&gt; &amp;amp; &quot;&apos;&#39;") == "<b> &amp; \"''");
+    REQUIRE(String::unescape_html("&#233;&#xe9;&#X20AC;&#128512;") == "\xc3\xa9\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80");
+    // anything else is kept as it is
+    REQUIRE(String::unescape_html("AT&T &nbsp; &#; &#xZZ; &#0; &#xd800; &#1114112; &") == "AT&T &nbsp; &#; &#xZZ; &#0; &#xd800; &#1114112; &");
+
+    String all;
+    for (int i = 0; i < 256; ++i)
+        all += String(static_cast<char>(i));
+    REQUIRE(String::unescape_html(all.escape_html()) == all);
+
+    String out("<");
+    out.escape_html(out);
+    REQUIRE(out == "<&lt;");
+}
+
+TEST_CASE("String percent encoding") {
+    REQUIRE(String("AZaz09-._~").percent_encode() == "AZaz09-._~");
+    REQUIRE(String("a b/c?d=\xc3\xa9").percent_encode() == "a%20b%2Fc%3Fd%3D%C3%A9");
+    String       buffer;
+    const String clean("Unreserved-chars_only.no~escaping");
+    REQUIRE(String::percent_encode(clean, buffer).data() == clean.data());
+    REQUIRE(String::percent_encode("a+b", buffer) == "a%2Bb");
+
+    REQUIRE(String::percent_decode("a%20b%2fc+d") == "a b/c+d");
+    for (const char* invalid : { "%", "%2", "%2g", "ab%" })
+        REQUIRE_THROWS_AS(String::percent_decode(invalid), std::invalid_argument);
+    String out("keep");
+    REQUIRE_THROWS_AS(String::percent_decode("%41%4", out), std::invalid_argument);
+    REQUIRE(out == "keep");
+
+    String all;
+    for (int i = 0; i < 256; ++i)
+        all += String(static_cast<char>(i));
+    const String encoded = all.percent_encode();
+    REQUIRE(encoded.size() == 66 + 190 * 3);
+    REQUIRE(String::percent_decode(encoded) == all);
+    REQUIRE(UncheckedString::percent_decode(UncheckedString("%41").percent_encode()) == "%41");
+}
+
+// textbook O(n * m) dynamic programming, with a free start in `b` if `search`
+static std::vector<std::size_t> naive_last_row(std::string_view a, std::string_view b, bool search) {
+    std::vector<std::size_t> row(b.size() + 1), previous(b.size() + 1);
+    for (std::size_t j = 0; j <= b.size(); ++j)
+        previous[j] = search ? 0 : j;
+    for (std::size_t i = 1; i <= a.size(); ++i) {
+        row[0] = i;
+        for (std::size_t j = 1; j <= b.size(); ++j)
+            row[j] = std::min({ previous[j] + 1, row[j - 1] + 1, previous[j - 1] + (a[i - 1] != b[j - 1]) });
+        row.swap(previous);
+    }
+    return previous;
+}
+
+TEST_CASE("String::edit_distance") {
+    REQUIRE(String("kitten").edit_distance("sitting") == 3);
+    REQUIRE(String("").edit_distance("abc") == 3);
+    REQUIRE(String("abc").edit_distance("") == 3);
+    REQUIRE(String("same").edit_distance("same") == 0);
+    REQUIRE(String("flaw").edit_distance("lawn") == 2);
+    REQUIRE(String("kitten").edit_distance("sitting", 2) == 3);
+    REQUIRE(String("kitten").edit_distance("sitting", 3) == 3);
+    REQUIRE(String("a").edit_distance("abcdefgh", 2) == 3);
+
+    // random strings over a small alphabet, across the 64 row block boundaries
+    std::uint32_t seed   = 42;
+    auto          random = [&seed](std::size_t n) {
+        std::string s;
+        for (std::size_t i = 0; i < n; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            s += static_cast<char>('a' + (seed >> 24) % 4);
+        }
+        return s;
+    };
+    for (std::size_t n : { 1, 7, 63, 64, 65, 130, 200 }) {
+        for (std::size_t m : { 1, 5, 64, 65, 129 }) {
+            const auto a        = random(n);
+            const auto b        = random(m);
+            const auto expected = naive_last_row(a, b, false).back();
+            REQUIRE(String(a.c_str()).edit_distance(b) == expected);
+            REQUIRE(String(b.c_str()).edit_distance(a) == expected);
+            REQUIRE(String(a.c_str()).edit_distance(b, expected) == expected);
+            if (expected > 0)
+                REQUIRE(String(a.c_str()).edit_distance(b, expected - 1) == expected);
+        }
+    }
+}
+
+TEST_CASE("String::edit_distances") {
+    const std::vector<String> names { "apple", "apply", "maple", "", "pineapple", "application" };
+    const std::vector<std::size_t> expected { 0, 1, 2, 5, 4, 7 };
+    REQUIRE(String::edit_distances("apple", names) == expected);
+    REQUIRE(String::edit_distances("apple", StringList(names)) == expected);
+    REQUIRE(String::edit_distances("apple", names, 2) == std::vector<std::size_t> { 0, 1, 2, 3, 3, 3 });
+    REQUIRE(String::edit_distances("", names) == std::vector<std::size_t> { 5, 5, 5, 0, 9, 11 });
+}
+
+TEST_CASE("String::fuzzy_find") {
+    const String text("the quick brown fox jumps over the lazy dog");
+    auto ends = [](const std::vector<String::FuzzyMatch>& matches) {
+        std::vector<std::size_t> result;
+        for (const auto& match : matches)
+            result.push_back(match.end);
+        return result;
+    };
+    REQUIRE(ends(text.fuzzy_find("fox", 0)) == std::vector<std::size_t> { 19 });
+    REQUIRE(ends(text.fuzzy_find("brwn", 1)) == std::vector<std::size_t> { 15 });
+    REQUIRE(ends(text.fuzzy_find("brwn", 2)) == std::vector<std::size_t> { 12, 13, 14, 15, 16 });
+    REQUIRE(text.fuzzy_find("cat", 0).empty());
+    REQUIRE(String("ab").fuzzy_find("", 0).size() == 3);
+    REQUIRE(String("xy").fuzzy_find("ab", 2).front().end == 0);
+
+    std::uint32_t seed   = 7;
+    auto          random = [&seed](std::size_t n) {
+        std::string s;
+        for (std::size_t i = 0; i < n; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            s += static_cast<char>('a' + (seed >> 24) % 3);
+        }
+        return s;
+    };
+    for (std::size_t m : { 3, 64, 70 }) {
+        const auto haystack = random(300);
+        const auto pattern  = random(m);
+        const auto row      = naive_last_row(pattern, haystack, true);
+        for (std::size_t k : { std::size_t(0), std::size_t(1), m / 3 }) {
+            std::vector<String::FuzzyMatch> expected;
+            for (std::size_t end = 0; end < row.size(); ++end)
+                if (row[end] <= k)
+                    expected.push_back({ end, row[end] });
+            const auto found = String(haystack.c_str()).fuzzy_find(pattern, k);
+            REQUIRE(found.size() == expected.size());
+            for (std::size_t i = 0; i < found.size(); ++i) {
+                REQUIRE(found[i].end == expected[i].end);
+                REQUIRE(found[i].errors == expected[i].errors);
+            }
+        }
+    }
+}
+
+TEST_CASE("String::rfind") {
+    const String path("/usr/local/lib/libstring.a");
+    REQUIRE(path.rfind('/') - path.begin() == 14);
+    REQUIRE(path.rfind('.') - path.begin() == 24);
+    REQUIRE(path.rfind('x') == path.end());
+    REQUIRE(path.rfind("lib") - path.begin() == 15);
+    REQUIRE(path.rfind("/usr") == path.begin());
+    REQUIRE(path.rfind("lib/libstring.a/") == path.end());
+    REQUIRE(path.rfind("") == path.end());
+    REQUIRE(String().rfind('a') == String().end());
+
+    String mutable_path = path;
+    *mutable_path.rfind('.') = '_';
+    REQUIRE(mutable_path == "/usr/local/lib/libstring_a");
+
+    // every position, across block boundaries, against std::string
+    std::string reference(100, 'a');
+    for (std::size_t i = 0; i < reference.size(); ++i) {
+        std::string text = reference;
+        text[i]          = 'b';
+        text.replace(0, std::min<std::size_t>(i, 3), "xyz", std::min<std::size_t>(i, 3));
+        const String s(text.c_str());
+        REQUIRE(std::size_t(s.rfind('b') - s.begin()) == text.rfind('b'));
+        REQUIRE(std::size_t(s.rfind("ab") - s.begin()) == (text.rfind("ab") == std::string::npos ? s.size() : text.rfind("ab")));
+        REQUIRE(std::size_t(s.rfind("aaaab") - s.begin()) == (text.rfind("aaaab") == std::string::npos ? s.size() : text.rfind("aaaab")));
+    }
+}
+
+TEST_CASE("String::count and String::find_all") {
+    const String csv("a,b,,c,d,e,f,g,h,i,j,k,l,m,n,o,p,q,r,s,t,u,v,w,x,y,z,1,2,3,4,5,6,7,8,9,0,");
+    REQUIRE(csv.count(',') == 37);
+    REQUIRE(csv.count('z') == 1);
+    REQUIRE(csv.count('#') == 0);
+    REQUIRE(String().count('a') == 0);
+    REQUIRE(String("aaaa").count("aa") == 2);
+    REQUIRE(String("abcabc").count("abc") == 2);
+    REQUIRE(String("abcabc").count("c") == 2);
+    REQUIRE_THROWS(String("abc").count(""));
+
+    std::vector<std::size_t> positions;
+    REQUIRE(String("a.b.c").find_all('.', positions) == 2);
+    REQUIRE(positions == std::vector<std::size_t> { 1, 3 });
+    REQUIRE(String("xx").find_all('.', positions) == 0);
+    REQUIRE(positions.empty());
+    REQUIRE(String("aaaaa").find_all("aa", positions) == 2);
+    REQUIRE(positions == std::vector<std::size_t> { 0, 2 });
+    REQUIRE_THROWS(String("abc").find_all("", positions));
+
+    std::vector<std::size_t> expected;
+    for (std::size_t i = 0; i < csv.size(); ++i)
+        if (csv.view()[i] == ',')
+            expected.push_back(i);
+    csv.find_all(',', positions);
+    REQUIRE(positions == expected);
+}
+
+TEST_CASE("String operator<<") {
+    std::ostringstream os;
+    os << String("abc") << '|' << std::setw(6) << String("abc") << '|' << std::left << std::setw(5)
+       << std::setfill('.') << String("ab") << '|' << String("") << String("xyz");
+    REQUIRE(os.str() == "abc|   abc|ab...|xyz");
+    String::Format fmt;
+    fmt.width     = 4;
+    fmt.fill      = '*';
+    fmt.alignment = String::Format::Align::Right;
+    REQUIRE(String::format(fmt, String("ab")) == "**ab");
+}
+
+TEST_CASE("write_all") {
+    std::vector<String> lines;
+    std::string         expected;
+    for (int i = 0; i < 3000; ++i) {
+        lines.push_back(String::format("line ", i, i % 7 == 0 ? "" : " with some text", "\n"));
+        expected += lines.back().to_std_string();
+    }
+    lines.push_back(String());
+
+    char path[] = "/tmp/string_write_all_XXXXXX";
+    const int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    REQUIRE(write_all(fd, lines) == expected.size());
+    REQUIRE(write_all(fd, String("tail")) == 4);
+    REQUIRE(write_all(fd, StringList { "!", "", "?" }) == 2);
+    ::close(fd);
+    std::ifstream in(path, std::ios::binary);
+    const std::string written((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    std::remove(path);
+    REQUIRE(written == expected + "tail!?");
+
+    REQUIRE_THROWS_AS(write_all(-1, lines), std::system_error);
+
+    // through a pipe, which takes far less than everything at once
+    int pipe_fds[2];
+    REQUIRE(::pipe(pipe_fds) == 0);
+    std::string piped;
+    std::thread reader([&] {
+        char    buffer[4096];
+        ssize_t n;
+        while ((n = ::read(pipe_fds[0], buffer, sizeof(buffer))) > 0)
+            piped.append(buffer, std::size_t(n));
+    });
+    std::size_t total = 0;
+    for (int i = 0; i < 20; ++i)
+        total += write_all(pipe_fds[1], lines);
+    ::close(pipe_fds[1]);
+    reader.join();
+    ::close(pipe_fds[0]);
+    REQUIRE(total == 20 * expected.size());
+    REQUIRE(piped.size() == total);
+    REQUIRE(piped.compare(0, expected.size(), expected) == 0);
+
+    std::ostringstream os;
+    write_all(os, std::vector<std::string_view> { "a", "bc", "", "d" });
+    REQUIRE(os.str() == "abcd");
+    write_all(os, lines);
+    REQUIRE(os.str() == "abcd" + expected);
+}
+
+TEST_CASE("String::c_str") {
+    // the terminator must follow the chars after every kind of modification
+    auto terminated = [](const String& s) {
+        return s.c_str()[s.size()] == '\0' && std::strlen(s.c_str()) == s.size();
+    };
+    String s;
+    REQUIRE(terminated(s));
+    REQUIRE(s.capacity() == 0);
+    REQUIRE(String("").capacity() == 0);
+    s += "hello";
+    REQUIRE(terminated(s));
+    REQUIRE(std::string(s.c_str()) == "hello");
+    s.insert(s.begin(), ' ');
+    s.insert(s.end(), String(" world "));
+    REQUIRE(terminated(s));
+    s.insert(s.begin() + 1, s);
+    REQUIRE(s == "  hello world hello world ");
+    REQUIRE(terminated(s));
+    s.erase(s.end() - 1);
+    s.erase(s.begin(), 2);
+    REQUIRE(terminated(s));
+    s.replace("world", "there!");
+    REQUIRE(terminated(s));
+    s.replace("there!", "folks!");
+    s.replace('!', '?');
+    REQUIRE(s == "hello folks? hello folks?");
+    REQUIRE(terminated(s));
+    s.to_upper();
+    s.collapse_whitespace();
+    s.strip("H?");
+    REQUIRE(s == "ELLO FOLKS? HELLO FOLKS");
+    REQUIRE(terminated(s));
+    s.trim();
+    s.rtrim();
+    s.ltrim();
+    REQUIRE(terminated(s));
+    s.to_hex(s);
+    REQUIRE(terminated(s));
+    s.clear();
+    REQUIRE(terminated(s));
+    REQUIRE(s.empty());
+    s += "again";
+    REQUIRE(terminated(s));
+
+    const String copy = s;
+    REQUIRE(terminated(copy));
+    String moved = std::move(s);
+    REQUIRE(terminated(moved));
+    REQUIRE(terminated(String('x')));
+    REQUIRE(terminated(String(copy.begin() + 1, copy.end())));
+    REQUIRE(terminated(String::join(", ", { "a", "b" })));
+    REQUIRE(terminated(String::format("n = ", 42)));
+
+    // '\0' is an ordinary char, and find / replace do not see the terminator
+    String with_null("ab");
+    with_null.insert(with_null.begin() + 1, '\0');
+    REQUIRE(with_null.size() == 3);
+    REQUIRE(with_null.c_str()[3] == '\0');
+    REQUIRE(with_null.find('\0') == with_null.begin() + 1);
+    const String plain("ab");
+    REQUIRE(plain.find('\0') == plain.end());
+    String untouched("xy");
+    untouched.replace('\0', 'z');
+    REQUIRE(untouched == "xy");
+    REQUIRE(terminated(untouched));
+
+    // capacity, size and iteration do not count the terminator
+    String reserved;
+    reserved.reserve(10);
+    REQUIRE(reserved.capacity() >= 10);
+    REQUIRE(reserved.size() == 0);
+    REQUIRE(std::distance(copy.begin(), copy.end()) == 5);
+    REQUIRE_THROWS_AS(copy.at(5), std::out_of_range);
+}
+
+TEST_CASE("String::operator[]") {
+    String s("hello");
+    REQUIRE(s[0] == 'h');
+    REQUIRE(s[4] == 'o');
+    s[0] = 'j';
+    REQUIRE(s == "jello");
+    const String& c = s;
+    REQUIRE(c[1] == 'e');
+    REQUIRE(c[1] == c.at(1));
+}
+
+TEST_CASE("UncheckedString") {
+    static_assert(!std::is_same_v<String, UncheckedString>);
+    UncheckedString s("hello, world");
+    REQUIRE(s.size() == 12);
+    REQUIRE(s.at(7) == 'w');
+    REQUIRE(s[7] == 'w');
+    s.insert(s.begin() + 5, '!');
+    s.erase(s.begin() + 6, 2);
+    REQUIRE(s.view() == "hello!world");
+    s.replace("world", "there");
+    REQUIRE(s.view() == "hello!there");
+    REQUIRE(s.split('!').size() == 2);
+    REQUIRE(UncheckedString::from_hex(s.to_hex()) == s);
+    REQUIRE(s.edit_distance("hello there") == 1);
+    REQUIRE(std::string(s.c_str()) == "hello!there");
+    std::stringstream ss;
+    ss << s;
+    REQUIRE(ss.str() == "hello!there");
+
+    // the policies convert into each other through views
+    const String checked(s.view());
+    REQUIRE(checked.view() == s.view());
+    REQUIRE(UncheckedString(checked.view()) == s);
+
+    // only the checked String throws on misuse
+    String bad("abc");
+    REQUIRE_THROWS_AS(bad.at(3), std::out_of_range);
+    REQUIRE_THROWS_AS(bad.erase(bad.end()), std::runtime_error);
+    REQUIRE_THROWS_AS(bad.insert(bad.end() + 1, 'x'), std::runtime_error);
+}
+
+TEST_CASE("Template") {
+    std::unordered_map<std::string_view, String> values { { "name", "Ada" }, { "id", "42" } };
+    const Template greeting("Hello ${name}, your order ${id}. Bye ${name}!");
+    REQUIRE(greeting.slot_count() == 2);
+    REQUIRE(greeting.slot_name(0) == "name");
+    REQUIRE(greeting.slot_name(1) == "id");
+    REQUIRE(greeting.render(values) == "Hello Ada, your order 42. Bye Ada!");
+
+    // a map without a value for a slot
+    values.erase("id");
+    REQUIRE_THROWS_AS(greeting.render(values), std::out_of_range);
+
+    // a callable lookup, and owning keys
+    REQUIRE(greeting.render([](std::string_view name) { return name == "name" ? "Bob" : "7"; }) == "Hello Bob, your order 7. Bye Bob!");
+    std::map<std::string, std::string> owning { { "name", "Eve" }, { "id", "1" } };
+    REQUIRE(greeting.render(owning) == "Hello Eve, your order 1. Bye Eve!");
+
+    // literal dollars, and templates without slots or text
+    REQUIRE(Template("$$${a} costs $5$").render([](std::string_view) { return "x"; }) == "$x costs $5$");
+    REQUIRE(Template("no slots").render(values) == "no slots");
+    REQUIRE(Template("").render(values).empty());
+    REQUIRE(Template("${a}${b}").render([](std::string_view name) { return name; }) == "ab");
+    REQUIRE_THROWS_AS(Template("oops ${name"), std::invalid_argument);
+    REQUIRE_THROWS_AS(Template("oops ${}"), std::invalid_argument);
+
+    // more slots than are looked up without an allocation
+    String many;
+    for (char c = 'a'; c <= 'z'; ++c)
+        many += String("${") + String(c) + "}";
+    REQUIRE(Template(many).render([](std::string_view name) { return name; }) == "abcdefghijklmnopqrstuvwxyz");
+
+    // render_to replaces the contents and reuses the buffer
+    const Template order("order ${id}");
+    String         out("previous contents, long enough to not need to grow");
+    const auto     capacity = out.capacity();
+    const char*    buffer   = out.data();
+    order.render_to(out, [](std::string_view) { return "12"; });
+    REQUIRE(out == "order 12");
+    REQUIRE(out.capacity() == capacity);
+    REQUIRE(out.data() == buffer);
+    REQUIRE(std::strlen(out.c_str()) == out.size());
+
+    // escaping applies to values only
+    struct Brackets {
+        std::size_t size(std::string_view value) const { return value.size() + 2; }
+        char*       write(std::string_view value, char* out) const {
+            *out++ = '[';
+            out    = std::copy(value.begin(), value.end(), out);
+            *out++ = ']';
+            return out;
+        }
+    };
+    REQUIRE(Template("<${a}>").render([](std::string_view) { return "<b>"; }, Brackets()) == "<[<b>]>");
+    UncheckedString unchecked;
+    Template("${a}-${a}").render_to(unchecked, [](std::string_view) { return "z"; }, Brackets());
+    REQUIRE(unchecked.view() == "[z]-[z]");
+}
+
+TEST_CASE("String ordering") {
+    REQUIRE(String("abc").compare("abd") < 0);
+    REQUIRE(String("abd").compare("abc") > 0);
+    REQUIRE(String("abc").compare("abc") == 0);
+    REQUIRE(String("ab").compare("abc") < 0);
+    REQUIRE(String("abc").compare("ab") > 0);
+    REQUIRE(String().compare("") == 0);
+    REQUIRE(String().compare("a") < 0);
+    // bytes compare unsigned, and '\0' is an ordinary char
+    REQUIRE(String("a").compare("\xe4") < 0);
+    String with_null("a");
+    with_null.insert(with_null.end(), '\0');
+    REQUIRE(String("a") < with_null);
+    REQUIRE(with_null < String("a\x01"));
+
+    REQUIRE(String("apple") < String("banana"));
+    REQUIRE(String("banana") > String("apple"));
+    REQUIRE(String("apple") <= String("apple"));
+    REQUIRE(String("apple") >= String("apple"));
+    REQUIRE_FALSE(String("apple") < String("apple"));
+    REQUIRE_FALSE(String("b") <= String("a"));
+
+    std::map<String, int> counts;
+    for (const auto& word : String("b a c a b a").split(' '))
+        ++counts[word];
+    REQUIRE(counts.size() == 3);
+    REQUIRE(counts.begin()->first == "a");
+    REQUIRE(counts["a"] == 3);
+    const std::set<UncheckedString> unchecked { "z", "y", "z" };
+    REQUIRE(unchecked.size() == 2);
+    REQUIRE(unchecked.begin()->view() == "y");
+}
+
+TEST_CASE("sort_strings") {
+    std::vector<String> small { "pear", "apple", "", "fig", "apple", "app" };
+    sort_strings(small);
+    REQUIRE(small == std::vector<String> { "", "app", "apple", "apple", "fig", "pear" });
+
+    // enough strings to take the radix sort path, with duplicates, shared prefixes, empty strings,
+    // '\0' and bytes above 127
+    std::uint32_t seed   = 7;
+    auto          random = [&seed](std::uint32_t below) {
+        seed = seed * 1664525u + 1013904223u;
+        return (seed >> 8) % below;
+    };
+    const char          alphabet[] = { 'a', 'b', '\0', '\xff', 'z' };
+    std::vector<String> strings;
+    for (std::size_t i = 0; i < 5000; ++i) {
+        String s(i % 3 == 0 ? "common/prefix/shared/by/many/" : "");
+        const auto length = random(12);
+        for (std::uint32_t j = 0; j < length; ++j)
+            s.insert(s.end(), alphabet[random(5)]);
+        strings.push_back(s);
+    }
+    strings.push_back(String(std::string_view(std::string(300, 'x'))));
+    strings.push_back(String(std::string_view(std::string(299, 'x'))));
+    auto expected = strings;
+    std::sort(expected.begin(), expected.end());
+    auto sorted = strings;
+    sort_strings(sorted);
+    REQUIRE(sorted == expected);
+
+    std::vector<std::string> std_strings;
+    for (const auto& s : strings)
+        std_strings.push_back(s.to_std_string());
+    sort_strings(std_strings);
+    REQUIRE(std::is_sorted(std_strings.begin(), std_strings.end()));
+    REQUIRE(std_strings.size() == strings.size());
+
+    StringList list;
+    for (const auto& s : strings)
+        list.push_back(s.view());
+    sort_strings(list);
+    REQUIRE(list == StringList(expected));
+
+    std::vector<String> none;
+    sort_strings(none);
+    REQUIRE(none.empty());
+}
+
+TEST_CASE("LineIndex") {
+    const String text("first\nsecond\n\nfourth");
+    LineIndex    lines(text.view());
+    REQUIRE(lines.line_count() == 4);
+    REQUIRE(lines.text_size() == text.size());
+    REQUIRE(lines.line_start(0) == 0);
+    REQUIRE(lines.line_start(1) == 6);
+    REQUIRE(lines.line_start(2) == 13);
+    REQUIRE(lines.line_start(3) == 14);
+    REQUIRE(lines.line_end(0) == 5);
+    REQUIRE(lines.line_end(2) == 13);
+    REQUIRE(lines.line_end(3) == text.size());
+    REQUIRE_THROWS_AS(lines.line_start(4), std::out_of_range);
+    REQUIRE(lines.line_of(0) == 0);
+    REQUIRE(lines.line_of(5) == 0); // the '\n' belongs to the line it ends
+    REQUIRE(lines.line_of(6) == 1);
+    REQUIRE(lines.line_of(13) == 2);
+    REQUIRE(lines.line_of(text.size()) == 3);
+    REQUIRE(lines.column_of(9) == 3);
+    REQUIRE_THROWS_AS(lines.line_of(text.size() + 1), std::out_of_range);
+
+    REQUIRE(LineIndex().line_count() == 1);
+    REQUIRE(LineIndex("\n").line_count() == 2);
+    REQUIRE(LineIndex("no newline").line_of(10) == 0);
+
+    String    doc("a\nb");
+    LineIndex doc_lines(doc.view());
+    doc_lines.insert(doc, 1, "x\ny");
+    REQUIRE(doc == "ax\ny\nb");
+    REQUIRE(doc_lines.line_count() == 3);
+    REQUIRE(doc_lines.line_start(2) == 5);
+    doc_lines.erase(doc, 0, 3);
+    REQUIRE(doc == "y\nb");
+    REQUIRE(doc_lines.line_count() == 2);
+    REQUIRE(doc_lines.line_start(1) == 2);
+    doc_lines.insert(doc, doc.size(), doc.view()); // a view into the text itself
+    REQUIRE(doc == "y\nby\nb");
+    REQUIRE(doc_lines.line_count() == 3);
+    REQUIRE_THROWS_AS(doc_lines.insert(doc, doc.size() + 1, "x"), std::out_of_range);
+    REQUIRE_THROWS_AS(doc_lines.erase(doc, 2, doc.size()), std::out_of_range);
+}
+
+TEST_CASE("LineIndex incremental updates") {
+    // enough lines for several blocks, edited at random, against an index built from scratch
+    std::uint32_t seed   = 99;
+    auto          random = [&seed](std::size_t below) {
+        seed = seed * 1664525u + 1013904223u;
+        return std::size_t(seed >> 8) % below;
+    };
+    String text;
+    for (std::size_t i = 0; i < 3 * LineIndex::block_size; ++i)
+        text += i % 7 == 0 ? "\n" : "line\n";
+    LineIndex lines(text.view());
+    auto      same = [&] {
+        const LineIndex fresh(text.view());
+        if (lines.line_count() != fresh.line_count() || lines.text_size() != text.size())
+            return false;
+        for (std::size_t line = 0; line < fresh.line_count(); ++line)
+            if (lines.line_start(line) != fresh.line_start(line))
+                return false;
+        for (std::size_t i = 0; i < 200; ++i) {
+            const auto offset = random(text.size() + 1);
+            if (lines.line_of(offset) != fresh.line_of(offset))
+                return false;
+        }
+        return true;
+    };
+    REQUIRE(same());
+    for (int edit = 0; edit < 200; ++edit) {
+        const auto offset = random(text.size() + 1);
+        if (random(2) == 0) {
+            String chars;
+            // sometimes enough newlines to split a block
+            const auto newlines = edit % 50 == 0 ? 2 * LineIndex::block_size : random(4);
+            for (std::size_t i = 0; i < newlines; ++i)
+                chars += random(2) ? "\n" : "ab\n";
+            chars += "tail";
+            lines.insert(text, offset, chars.view());
+        } else {
+            // sometimes large erases spanning several blocks
+            const auto count = random(edit % 40 == 0 ? text.size() / 2 : 64);
+            lines.erase(text, offset, std::min(count, text.size() - offset));
+        }
+        REQUIRE(same());
+    }
+    lines.erase(text, 0, text.size());
+    REQUIRE(lines.line_count() == 1);
+    REQUIRE(text.empty());
+
+    // a paste of many blocks worth of newlines is split into blocks of at most block_size
+    text = "first\nlast\n";
+    lines.rebuild(text.view());
+    String paste;
+    for (std::size_t i = 0; i < 10 * LineIndex::block_size; ++i)
+        paste += "pasted\n";
+    lines.insert(text, 6, paste.view());
+    REQUIRE(lines.block_count() >= 10);
+    REQUIRE(same());
+}
+
+TEST_CASE("GapString") {
+    GapString text("hello world");
+    REQUIRE(text.size() == 11);
+    REQUIRE(text.gap_position() == 11);
+    text.insert(5, ",");
+    text.insert(0, 'H');
+    text.erase(1);
+    REQUIRE(text == "Hello, world");
+    REQUIRE(text.gap_position() == 1);
+    REQUIRE(text.before_gap() == "H");
+    REQUIRE(text.after_gap() == "ello, world");
+    REQUIRE(text[1] == 'e');
+    REQUIRE(text.at(11) == 'd');
+    REQUIRE_THROWS_AS(text.at(12), std::out_of_range);
+    REQUIRE_THROWS_AS(text.insert(13, "x"), std::out_of_range);
+    REQUIRE_THROWS_AS(text.erase(10, 3), std::out_of_range);
+    REQUIRE(std::string(text.begin(), text.end()) == "Hello, world");
+    REQUIRE(std::count(text.begin(), text.end(), 'o') == 2);
+
+    // finding, also across the gap
+    REQUIRE(text.find('o') == 4);
+    REQUIRE(text.find('o', 5) == 8);
+    REQUIRE(text.find('z') == GapString::npos);
+    text.move_gap(3);
+    REQUIRE(text.find("llo") == 2);
+    REQUIRE(text.find("lo, w") == 3);
+    REQUIRE(text.find("Hel") == 0);
+    REQUIRE(text.find("world", 3) == 7);
+    REQUIRE(text.find("world", 8) == GapString::npos);
+    REQUIRE(text.find("") == 0);
+
+    // the view is O(1) once the gap is at the end
+    REQUIRE(text.view() == "Hello, world");
+    REQUIRE(text.gap_position() == text.size());
+    const char* data = text.view().data();
+    REQUIRE(text.view().data() == data);
+
+    // inserting chars of itself
+    text.insert(0, text.view().substr(7));
+    REQUIRE(text == "worldHello, world");
+
+    REQUIRE(text.to_string() == "worldHello, world");
+    String released = text.release();
+    REQUIRE(released == "worldHello, world");
+    REQUIRE(std::strlen(released.c_str()) == released.size());
+    REQUIRE(text.empty());
+    REQUIRE(text.release().empty());
+    REQUIRE(GapString().to_string().empty());
+
+    // taking over a String's buffer, and handing it back without copying
+    String big(std::string_view(std::string(1000, 'x')));
+    const char* buffer = big.data();
+    GapString   editor(std::move(big));
+    REQUIRE(editor.size() == 1000);
+    editor.erase(0, 10);
+    editor.insert(990, "end");
+    const String back = editor.release();
+    REQUIRE(back.size() == 993);
+    REQUIRE(back.data() == buffer);
+    REQUIRE(back.view().substr(988) == "xxend");
+}
+
+TEST_CASE("GapString random edits") {
+    std::uint32_t seed   = 3;
+    auto          random = [&seed](std::size_t below) {
+        seed = seed * 1664525u + 1013904223u;
+        return std::size_t(seed >> 8) % below;
+    };
+    GapString   text;
+    std::string expected;
+    std::size_t cursor = 0;
+    for (int edit = 0; edit < 5000; ++edit) {
+        // mostly typing around a cursor, sometimes a jump
+        if (random(20) == 0)
+            cursor = random(expected.size() + 1);
+        cursor = std::min(cursor, expected.size());
+        if (random(3) != 0 || expected.empty()) {
+            const std::string chars(1 + random(3), char('a' + random(3)));
+            text.insert(cursor, chars);
+            expected.insert(cursor, chars);
+            cursor += chars.size();
+        } else {
+            const auto position = cursor == 0 ? 0 : cursor - 1;
+            const auto count    = std::min<std::size_t>(1 + random(2), expected.size() - position);
+            text.erase(position, count);
+            expected.erase(position, count);
+            cursor = position;
+        }
+        REQUIRE(text.size() == expected.size());
+        if (edit % 100 == 0) {
+            REQUIRE(text == expected);
+            const std::string needle = expected.substr(random(expected.size() + 1), 3);
+            const auto        from   = random(expected.size() + 1);
+            REQUIRE(text.find(needle, from) == (expected.find(needle, from) == std::string::npos ? GapString::npos : expected.find(needle, from)));
+        }
+    }
+    REQUIRE(text.view() == expected);
+}
+
+TEST_CASE("ReplaceFilter") {
+    // the same rules on the whole text at once: leftmost match, longest of those, no rescanning
+    auto replace_all = [](std::string_view text, const std::vector<std::pair<String, String>>& replacements) {
+        std::string result;
+        for (std::size_t i = 0; i < text.size();) {
+            const std::pair<String, String>* best = nullptr;
+            for (const auto& replacement : replacements)
+                if (text.substr(i, replacement.first.size()) == replacement.first.view()
+                    && (!best || replacement.first.size() > best->first.size()))
+                    best = &replacement;
+            if (best) {
+                result += best->second.view();
+                i += best->first.size();
+            } else {
+                result += text[i++];
+            }
+        }
+        return result;
+    };
+    const std::vector<std::pair<String, String>> replacements { { "aa", "b" }, { "aaa", "<3>" }, { "ab", "" }, { "c", "cc" } };
+    std::uint32_t seed = 5;
+    std::string   text;
+    for (int i = 0; i < 2000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        text += "aabc"[(seed >> 24) % 4];
+    }
+    const auto expected = replace_all(text, replacements);
+    for (std::size_t chunk : { 1, 2, 3, 4, 7, 64, 5000 }) {
+        ReplaceFilter filter(replacements);
+        std::string   result;
+        for (std::size_t i = 0; i < text.size(); i += chunk)
+            result += filter.process(std::string_view(text).substr(i, chunk));
+        result += filter.finish();
+        INFO("chunk size " << chunk);
+        REQUIRE(result == expected);
+        REQUIRE(filter.stats().bytes_read == text.size());
+        REQUIRE(filter.stats().bytes_written == expected.size());
+        REQUIRE(filter.stats().matches == filter.stats().matches_per_pattern[0] + filter.stats().matches_per_pattern[1]
+                    + filter.stats().matches_per_pattern[2] + filter.stats().matches_per_pattern[3]);
+    }
+
+    // a match right across the boundary of two chunks
+    ReplaceFilter single("needle", "pin", 4);
+    std::string   out(single.process("hayneed"));
+    out += single.process("le hay");
+    out += single.finish();
+    REQUIRE(out == "haypin hay");
+    REQUIRE(single.stats().matches == 1);
+    single.reset();
+    REQUIRE(single.stats().matches == 0);
+    std::string unfinished(single.process("needl"));
+    unfinished += single.finish();
+    REQUIRE(unfinished == "needl");
+
+    // streams, with chunks much smaller than the text
+    std::stringstream in(text);
+    std::stringstream streamed;
+    ReplaceFilter     stream_filter(replacements, 100);
+    const auto&       stats = stream_filter.run(in, streamed);
+    REQUIRE(streamed.str() == expected);
+    REQUIRE(stats.bytes_read == text.size());
+    REQUIRE(stats.seconds > 0);
+    REQUIRE(stats.bytes_per_second() > 0);
+
+    // file descriptors
+    char      in_path[] = "/tmp/string_filter_in_XXXXXX";
+    char      out_path[] = "/tmp/string_filter_out_XXXXXX";
+    const int in_fd      = mkstemp(in_path);
+    const int out_fd     = mkstemp(out_path);
+    REQUIRE(in_fd >= 0);
+    REQUIRE(out_fd >= 0);
+    write_all(in_fd, text);
+    ::lseek(in_fd, 0, SEEK_SET);
+    ReplaceFilter(replacements, 333).run(in_fd, out_fd);
+    ::close(in_fd);
+    ::close(out_fd);
+    std::ifstream     written_file(out_path, std::ios::binary);
+    const std::string written((std::istreambuf_iterator<char>(written_file)), std::istreambuf_iterator<char>());
+    std::remove(in_path);
+    std::remove(out_path);
+    REQUIRE(written == expected);
+    REQUIRE_THROWS_AS(ReplaceFilter("a", "b").run(-1, 1), std::system_error);
+
+    REQUIRE_THROWS_AS(ReplaceFilter("", "x"), std::invalid_argument);
+    REQUIRE_THROWS_AS(ReplaceFilter("a", "b", 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(ReplaceFilter(std::vector<std::pair<String, String>> {}), std::invalid_argument);
+}
+
+TEST_CASE("MappedFile") {
+    char      path[] = "/tmp/string_mapped_XXXXXX";
+    const int fd     = mkstemp(path);
+    REQUIRE(fd >= 0);
+    {
+        const MappedFile empty(path);
+        REQUIRE(empty.view().empty());
+    }
+    write_all(fd, std::string_view("mapped contents"));
+    ::close(fd);
+    MappedFile file(path);
+    std::remove(path);
+    REQUIRE(file.view() == "mapped contents");
+    MappedFile moved(std::move(file));
+    REQUIRE(file.view().empty());
+    REQUIRE(moved.view() == "mapped contents");
+    REQUIRE_THROWS_AS(MappedFile("/nonexistent/file"), std::system_error);
+}
+
+TEST_CASE("SubstringIndex") {
+    // every occurance, by brute force
+    auto naive_find_all = [](std::string_view text, std::string_view pattern) {
+        std::vector<std::size_t> offsets;
+        for (std::size_t i = 0; i + pattern.size() <= text.size(); ++i)
+            if (text.compare(i, pattern.size(), pattern) == 0)
+                offsets.push_back(i);
+        return offsets;
+    };
+
+    const String banana("banana");
+    SubstringIndex index(banana);
+    REQUIRE(index.size() == 6);
+    const std::vector<std::size_t> sorted { 5, 3, 1, 0, 4, 2 };
+    const std::vector<std::size_t> lcps { 0, 1, 3, 0, 0, 2 };
+    for (std::size_t rank = 0; rank < 6; ++rank) {
+        REQUIRE(index.suffix(rank) == sorted[rank]);
+        REQUIRE(index.lcp(rank) == lcps[rank]);
+    }
+    REQUIRE(index.contains("nan"));
+    REQUIRE_FALSE(index.contains("nab"));
+    REQUIRE_FALSE(index.contains("bananas"));
+    REQUIRE(index.count("ana") == 2);
+    REQUIRE(index.count("a") == 3);
+    REQUIRE(index.count("") == 7);
+    REQUIRE(index.find_all("ana") == std::vector<std::size_t> { 1, 3 });
+    REQUIRE(index.find_all("x").empty());
+    REQUIRE(index.longest_repeat() == "ana");
+
+    REQUIRE(SubstringIndex(std::string_view()).count("a") == 0);
+    REQUIRE(SubstringIndex(std::string_view()).longest_repeat().empty());
+
+    // random texts over small alphabets, which have long repeats, and degenerate ones
+    std::uint32_t       seed = 4242;
+    std::vector<String> texts { String(std::string(1000, 'a')), String(), String() };
+    for (int i = 0; i < 300; ++i) {
+        texts[1] += String("ab");
+        texts[2] += String("abc");
+    }
+    texts[2] += String("ab");
+    for (std::size_t alphabet : { 2, 4, 26 }) {
+        for (std::size_t n : { 1, 2, 3, 17, 100, 2000 }) {
+            String text;
+            for (std::size_t i = 0; i < n; ++i) {
+                seed = seed * 1664525u + 1013904223u;
+                text += String(static_cast<char>('a' + (seed >> 16) % alphabet));
+            }
+            texts.push_back(text);
+        }
+    }
+    String binary;
+    for (int i = 0; i < 1000; ++i)
+        binary += String(static_cast<char>((i * 37) % 256));
+    texts.push_back(binary);
+
+    for (const auto& text : texts) {
+        const SubstringIndex idx(text);
+        const auto           view = text.view();
+        for (std::size_t rank = 1; rank < idx.size(); ++rank) {
+            const auto previous = view.substr(idx.suffix(rank - 1));
+            const auto current  = view.substr(idx.suffix(rank));
+            REQUIRE(String(previous) < String(current));
+            std::size_t common = 0;
+            while (common < current.size() && common < previous.size() && current[common] == previous[common])
+                ++common;
+            REQUIRE(idx.lcp(rank) == common);
+        }
+        for (int q = 0; q < 30; ++q) {
+            seed = seed * 1664525u + 1013904223u;
+            const auto start   = (seed >> 8) % view.size();
+            const auto length  = 1 + (seed >> 4) % 8;
+            auto       pattern = String(view.substr(start, length));
+            if (q % 3 == 0)
+                pattern += String("b");
+            const auto expected = naive_find_all(view, pattern);
+            REQUIRE(idx.find_all(pattern) == expected);
+            REQUIRE(idx.count(pattern) == expected.size());
+            REQUIRE(idx.contains(pattern) == !expected.empty());
+        }
+    }
+
+    // saved, and mapped back in for the same text only
+    String corpus;
+    for (int i = 0; i < 5000; ++i)
+        corpus += String::format("line ", i % 97, " of the corpus\n");
+    char      path[] = "/tmp/string_substring_index_XXXXXX";
+    const int fd     = mkstemp(path);
+    REQUIRE(fd >= 0);
+    ::close(fd);
+    const SubstringIndex built(corpus);
+    built.save(path);
+    SubstringIndex loaded = SubstringIndex::load(path, corpus);
+    REQUIRE(loaded.size() == corpus.size());
+    for (std::size_t rank = 0; rank < corpus.size(); rank += 101) {
+        REQUIRE(loaded.suffix(rank) == built.suffix(rank));
+        REQUIRE(loaded.lcp(rank) == built.lcp(rank));
+    }
+    REQUIRE(loaded.count("line 42 ") == 52);
+    REQUIRE(loaded.find_all("line 96 ") == built.find_all("line 96 "));
+    SubstringIndex moved(std::move(loaded));
+    REQUIRE(loaded.size() == 0);
+    REQUIRE_FALSE(loaded.contains("line"));
+    REQUIRE(moved.contains("line 13 of"));
+
+    String changed = corpus;
+    changed[10]    = 'X';
+    REQUIRE_THROWS_AS(SubstringIndex::load(path, changed), std::runtime_error);
+    REQUIRE_THROWS_AS(SubstringIndex::load(path, corpus.view().substr(1)), std::runtime_error);
+    // damaged arrays, a suffix past the text and an LCP past the end of its suffix
+    const auto arrays = std::size_t(std::ifstream(path, std::ios::binary | std::ios::ate).tellg()) - 8 * corpus.size();
+    for (std::size_t offset : { arrays + 4 * 7, arrays + 4 * (corpus.size() + 7) }) {
+        built.save(path);
+        const std::uint32_t damaged = std::uint32_t(corpus.size() + 1);
+        std::fstream(path, std::ios::binary | std::ios::in | std::ios::out).seekp(std::streamoff(offset)).write(
+            reinterpret_cast<const char*>(&damaged), sizeof damaged);
+        REQUIRE_THROWS_AS(SubstringIndex::load(path, corpus), std::runtime_error);
+    }
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "not an index at all, not even close";
+    REQUIRE_THROWS_AS(SubstringIndex::load(path, corpus), std::runtime_error);
+    std::remove(path);
+    REQUIRE_THROWS_AS(SubstringIndex::load(path, corpus), std::system_error);
+}
@@ -0,0 +1,404 @@
+// Complexity and throughput regression tests.
+//
+// Each core operation is run at growing input sizes. The time it takes must grow no faster than the
+// complexity it's documented to have (with some slack for noise), so that an accidentally quadratic
+// implementation fails. The throughput at the largest size is reported, and only compared against
+// the checked-in baseline in `test/perf_baseline.txt` on request, as absolute numbers depend on the
+// machine and its load.
+//
+// Environment variables:
+//   STRING_PERF_CHECK_THROUGHPUT if set, fails when the throughput is below the baseline
+//   STRING_PERF_TOLERANCE        fraction of the baseline throughput that may be lost, default 0.5
+//   STRING_PERF_UPDATE_BASELINE  if set, rewrites the baseline file with the measured throughput
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include "../include/String.h"
+#include "../include/Csv.h"
+#include "../include/Glob.h"
+#include "../include/StringList.h"
+#include "../include/Template.h"
+#include "../include/StringSort.h"
+#include "../include/LineIndex.h"
+#include "../include/GapString.h"
+#include "../include/ReplaceFilter.h"
+#include "../include/SubstringIndex.h"
+
+#define CATCH_CONFIG_MAIN
+#include "Catch2/single_include/catch2/catch.hpp"
+
+#ifndef STRING_PERF_BASELINE
+#define STRING_PERF_BASELINE "test/perf_baseline.txt"
+#endif
+
+namespace {
+
+enum class Complexity
+{
+    Linear,
+    Linearithmic,
+};
+
+// sizes the operations are run at, each twice the previous one
+constexpr std::size_t base_size = 1 << 20;
+constexpr int         steps     = 4;
+constexpr int         repeats   = 7;
+
+std::map<std::string, double>& measured_throughput() {
+    static std::map<std::string, double> throughput;
+    return throughput;
+}
+
+std::map<std::string, double> load_baseline() {
+    std::map<std::string, double> baseline;
+    std::ifstream                 file(STRING_PERF_BASELINE);
+    std::string                   name;
+    double                        bytes_per_second;
+    while (file >> name >> bytes_per_second)
+        baseline[name] = bytes_per_second;
+    return baseline;
+}
+
+void save_baseline() {
+    auto baseline = load_baseline();
+    for (const auto& entry : measured_throughput())
+        baseline[entry.first] = entry.second;
+    std::ofstream file(STRING_PERF_BASELINE);
+    file << std::fixed;
+    for (const auto& entry : baseline)
+        file << entry.first << ' ' << std::llround(entry.second) << '\n';
+}
+
+double tolerance() {
+    const char* value = std::getenv("STRING_PERF_TOLERANCE");
+    return value ? std::atof(value) : 0.5;
+}
+
+// fastest of `repeats` runs of `run`, after `setup` prepared its input, in seconds
+double time_of(const std::function<void()>& setup, const std::function<void()>& run) {
+    double best = 1e9;
+    for (int i = 0; i < repeats; ++i) {
+        setup();
+        const auto start = std::chrono::steady_clock::now();
+        run();
+        const auto end = std::chrono::steady_clock::now();
+        best           = std::min(best, std::chrono::duration<double>(end - start).count());
+    }
+    return best;
+}
+
+// `make_case(n)` returns a pair of setup and run functions operating on an input of about n bytes
+void check_operation(const std::string& name, Complexity complexity,
+    const std::function<std::pair<std::function<void()>, std::function<void()>>(std::size_t)>& make_case) {
+    std::vector<double> times;
+    std::size_t         n = base_size;
+    for (int step = 0; step < steps; ++step, n *= 2) {
+        auto test_case = make_case(n);
+        times.push_back(time_of(test_case.first, test_case.second));
+    }
+    // fit time = c * n^exponent over all steps. Linear is an exponent of 1, quadratic one of 2.
+    double mean_x = 0, mean_y = 0;
+    for (int step = 0; step < steps; ++step) {
+        mean_x += std::log(double(base_size << step)) / steps;
+        mean_y += std::log(std::max(times[step], 1e-9)) / steps;
+    }
+    double covariance = 0, variance = 0;
+    for (int step = 0; step < steps; ++step) {
+        const double x = std::log(double(base_size << step)) - mean_x;
+        covariance += x * (std::log(std::max(times[step], 1e-9)) - mean_y);
+        variance += x * x;
+    }
+    const double exponent = covariance / variance;
+    const double largest  = double(base_size << (steps - 1));
+    double       expected = 1.0;
+    if (complexity == Complexity::Linearithmic)
+        expected += std::log(std::log2(largest) / std::log2(double(base_size))) / std::log(largest / double(base_size));
+    // slack for timer noise and inputs outgrowing the caches, while quadratic stays well outside
+    const double envelope = expected + 0.5;
+    INFO(name << ": time grows with n^" << exponent << ", allowed is n^" << envelope);
+    CHECK(exponent <= envelope);
+
+    const double throughput = largest / times.back();
+    measured_throughput()[name] = throughput;
+    const auto baseline         = load_baseline();
+    const auto entry            = baseline.find(name);
+    if (std::getenv("STRING_PERF_UPDATE_BASELINE")) {
+        save_baseline();
+    } else if (entry == baseline.end()) {
+        WARN(name << ": no baseline, measured " << std::llround(throughput) << " bytes/s");
+    } else if (std::getenv("STRING_PERF_CHECK_THROUGHPUT")) {
+        INFO(name << ": " << std::llround(throughput) << " bytes/s, baseline is " << std::llround(entry->second) << " bytes/s");
+        CHECK(throughput >= entry->second * (1.0 - tolerance()));
+    } else if (throughput < entry->second * (1.0 - tolerance())) {
+        WARN(name << ": " << std::llround(throughput) << " bytes/s, below the baseline of " << std::llround(entry->second) << " bytes/s");
+    }
+}
+
+String make_text(std::size_t n) {
+    const char* words[] = { "lorem", "ipsum", "dolor", "sit", "amet", "needle", "consectetur", "adipiscing" };
+    String      result;
+    result.reserve(n + 16);
+    for (std::size_t i = 0; result.size() < n; ++i) {
+        result += words[(i * 7 + i / 3) % 8];
+        result += (i % 11 == 10) ? String(",") : String(" ");
+    }
+    return result;
+}
+
+}
+
+TEST_CASE("perf: construct") {
+    check_operation("construct", Complexity::Linear, [](std::size_t n) {
+        auto text = std::make_shared<std::string>(make_text(n).to_std_string());
+        auto out  = std::make_shared<String>();
+        return std::make_pair([] {}, [=] { *out = String(text->c_str()); });
+    });
+}
+
+TEST_CASE("perf: copy") {
+    check_operation("copy", Complexity::Linear, [](std::size_t n) {
+        auto text = std::make_shared<String>(make_text(n));
+        auto out  = std::make_shared<String>();
+        return std::make_pair([=] { *out = String(); }, [=] { *out = *text; });
+    });
+}
+
+TEST_CASE("perf: operator+") {
+    check_operation("operator+", Complexity::Linear, [](std::size_t n) {
+        auto a   = std::make_shared<String>(make_text(n / 2));
+        auto b   = std::make_shared<String>(make_text(n / 2));
+        auto out = std::make_shared<String>();
+        return std::make_pair([] {}, [=] { *out = *a + *b; });
+    });
+}
+
+TEST_CASE("perf: find") {
+    check_operation("find", Complexity::Linear, [](std::size_t n) {
+        auto text  = std::make_shared<String>(make_text(n));
+        auto found = std::make_shared<bool>();
+        return std::make_pair([] {}, [=] { *found = text->find("not in there") != text->end(); });
+    });
+}
+
+TEST_CASE("perf: replace") {
+    check_operation("replace", Complexity::Linear, [](std::size_t n) {
+        auto original = std::make_shared<String>(make_text(n));
+        auto text     = std::make_shared<String>();
+        return std::make_pair([=] { *text = *original; }, [=] { text->replace("needle", "pin"); });
+    });
+}
+
+TEST_CASE("perf: split") {
+    check_operation("split", Complexity::Linear, [](std::size_t n) {
+        auto text  = std::make_shared<String>(make_text(n));
+        auto parts = std::make_shared<std::vector<String>>();
+        return std::make_pair([] {}, [=] { *parts = text->split(' '); });
+    });
+}
+
+TEST_CASE("perf: split_into") {
+    check_operation("split_into", Complexity::Linear, [](std::size_t n) {
+        auto text  = std::make_shared<String>(make_text(n));
+        auto parts = std::make_shared<StringList>();
+        return std::make_pair([] {}, [=] { text->split_into(*parts, ' '); });
+    });
+}
+
+TEST_CASE("perf: join") {
+    check_operation("join", Complexity::Linear, [](std::size_t n) {
+        auto parts = std::make_shared<std::vector<String>>(make_text(n).split(' '));
+        auto out   = std::make_shared<String>();
+        return std::make_pair([] {}, [=] { *out = String::join(" ", *parts); });
+    });
+}
+
+TEST_CASE("perf: insert and erase") {
+    check_operation("insert_erase", Complexity::Linear, [](std::size_t n) {
+        auto text = std::make_shared<String>(make_text(n));
+        return std::make_pair([] {}, [=] {
+            text->insert(text->begin() + text->size() / 2, "inserted");
+            text->erase(text->begin() + text->size() / 2, 8);
+        });
+    });
+}
+
+TEST_CASE("perf: to_lower and collapse_whitespace") {
+    check_operation("normalize", Complexity::Linear, [](std::size_t n) {
+        auto original = std::make_shared<String>(make_text(n));
+        auto text     = std::make_shared<String>();
+        return std::make_pair([=] { *text = *original; }, [=] {
+            text->to_upper();
+            text->collapse_whitespace();
+        });
+    });
+}
+
+TEST_CASE("perf: CsvReader") {
+    check_operation("csv", Complexity::Linear, [](std::size_t n) {
+        auto text   = std::make_shared<String>(make_text(n));
+        auto fields = std::make_shared<std::size_t>();
+        return std::make_pair([] {}, [=] {
+            CsvReader reader(*text, CsvDialect::csv());
+            CsvRecord record;
+            while (reader.next(record))
+                *fields += record.size();
+        });
+    });
+}
+
+TEST_CASE("perf: GlobPattern") {
+    check_operation("glob", Complexity::Linear, [](std::size_t n) {
+        auto text    = std::make_shared<String>(make_text(n));
+        auto pattern = std::make_shared<GlobPattern>("*needle*[0-9]*lorem?");
+        auto matched = std::make_shared<bool>();
+        return std::make_pair([] {}, [=] { *matched = pattern->matches(*text); });
+    });
+}
+
+TEST_CASE("perf: hex and Base64") {
+    check_operation("hex", Complexity::Linear, [](std::size_t n) {
+        auto text = std::make_shared<String>(make_text(n));
+        auto out  = std::make_shared<String>();
+        return std::make_pair([=] { *out = String(); }, [=] {
+            text->to_hex(*out);
+            String::from_hex(*out);
+        });
+    });
+    check_operation("base64", Complexity::Linear, [](std::size_t n) {
+        auto text = std::make_shared<String>(make_text(n));
+        auto out  = std::make_shared<String>();
+        return std::make_pair([=] { *out = String(); }, [=] {
+            text->to_base64(*out);
+            String::from_base64(*out);
+        });
+    });
+}
+
+TEST_CASE("perf: escaping") {
+    check_operation("escape", Complexity::Linear, [](std::size_t n) {
+        auto text = std::make_shared<String>(make_text(n));
+        auto out  = std::make_shared<String>();
+        return std::make_pair([=] { *out = String(); }, [=] {
+            text->escape_json(*out);
+            text->escape_html(*out);
+            text->percent_encode(*out);
+            String::percent_decode(*out);
+        });
+    });
+}
+
+TEST_CASE("perf: edit distance") {
+    check_operation("fuzzy_find", Complexity::Linear, [](std::size_t n) {
+        auto text    = std::make_shared<String>(make_text(n));
+        auto matches = std::make_shared<std::size_t>();
+        return std::make_pair([] {}, [=] { *matches = text->fuzzy_find("consetcetur", 2).size(); });
+    });
+    check_operation("edit_distances", Complexity::Linear, [](std::size_t n) {
+        auto names = std::make_shared<StringList>();
+        make_text(n).split_into(*names, ' ');
+        auto distances = std::make_shared<std::vector<std::size_t>>();
+        return std::make_pair([] {}, [=] { *distances = String::edit_distances("adipisicng", *names, 3); });
+    });
+}
+
+TEST_CASE("perf: rfind, count and find_all") {
+    check_operation("rfind", Complexity::Linear, [](std::size_t n) {
+        auto text  = std::make_shared<String>(make_text(n));
+        auto found = std::make_shared<std::size_t>();
+        return std::make_pair([] {}, [=] {
+            *found = std::size_t(text->rfind("lorem,ipsum") - text->begin()) + std::size_t(text->rfind('#') - text->begin());
+        });
+    });
+    check_operation("count", Complexity::Linear, [](std::size_t n) {
+        auto text  = std::make_shared<String>(make_text(n));
+        auto count = std::make_shared<std::size_t>();
+        return std::make_pair([] {}, [=] { *count = text->count(' ') + text->count("needle"); });
+    });
+    check_operation("find_all", Complexity::Linear, [](std::size_t n) {
+        auto text      = std::make_shared<String>(make_text(n));
+        auto positions = std::make_shared<std::vector<std::size_t>>();
+        return std::make_pair([] {}, [=] { text->find_all(',', *positions); });
+    });
+}
+
+TEST_CASE("perf: template") {
+    check_operation("template", Complexity::Linear, [](std::size_t n) {
+        String source;
+        while (source.size() < n)
+            source += "Hello ${name}, your order ${id} ships on ${date}. ";
+        auto compiled = std::make_shared<Template>(source);
+        auto values   = std::make_shared<std::unordered_map<std::string_view, String>>();
+        (*values)["name"] = "Grace Hopper";
+        (*values)["id"]   = "1234567";
+        (*values)["date"] = "2024-05-01";
+        auto out = std::make_shared<String>();
+        return std::make_pair([] {}, [=] { compiled->render_to(*out, *values); });
+    });
+}
+
+TEST_CASE("perf: sort_strings") {
+    check_operation("sort_strings", Complexity::Linearithmic, [](std::size_t n) {
+        // distinct keys with a shared prefix, in random order
+        std::vector<String> keys;
+        std::uint32_t       seed = 1;
+        for (std::size_t size = 0; size < n; size += keys.back().size()) {
+            seed = seed * 1664525u + 1013904223u;
+            keys.push_back(String("user/") + String(std::string_view(reinterpret_cast<const char*>(&seed), sizeof(seed))).to_hex());
+        }
+        auto sorted = std::make_shared<std::vector<String>>();
+        return std::make_pair([=] { *sorted = keys; }, [=] { sort_strings(*sorted); });
+    });
+}
+
+TEST_CASE("perf: line index") {
+    check_operation("line_index", Complexity::Linear, [](std::size_t n) {
+        auto text  = std::make_shared<String>(make_text(n));
+        text->replace(',', '\n');
+        auto lines = std::make_shared<LineIndex>();
+        return std::make_pair([] {}, [=] { lines->rebuild(text->view()); });
+    });
+}
+
+TEST_CASE("perf: gap string") {
+    check_operation("gap_string", Complexity::Linear, [](std::size_t n) {
+        auto text = std::make_shared<GapString>();
+        // typing n chars, with the cursor jumping back a little every line
+        return std::make_pair([=] { text->clear(); }, [=] {
+            std::size_t cursor = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                text->insert(cursor++, char('a' + i % 26));
+                if (i % 64 == 63)
+                    cursor -= 32;
+            }
+        });
+    });
+}
+
+TEST_CASE("perf: replace filter") {
+    check_operation("replace_filter", Complexity::Linear, [](std::size_t n) {
+        auto text   = std::make_shared<String>(make_text(n));
+        auto filter = std::make_shared<ReplaceFilter>(std::vector<std::pair<String, String>> { { "needle", "pin" }, { "lorem", "LOREM" } });
+        auto size   = std::make_shared<std::size_t>();
+        return std::make_pair([=] { filter->reset(); }, [=] {
+            const auto  chars = text->view();
+            std::size_t out   = 0;
+            for (std::size_t i = 0; i < chars.size(); i += ReplaceFilter::default_chunk_size)
+                out += filter->process(chars.substr(i, ReplaceFilter::default_chunk_size)).size();
+            *size = out + filter->finish().size();
+        });
+    });
+}
+
+TEST_CASE("perf: substring index") {
+    check_operation("substring_index", Complexity::Linear, [](std::size_t n) {
+        auto text  = std::make_shared<String>(make_text(n));
+        auto index = std::make_shared<SubstringIndex>();
+        return std::make_pair([=] { *index = SubstringIndex(); }, [=] { *index = SubstringIndex(*text); });
+    });
+}